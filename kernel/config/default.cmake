@@ -1,8 +1,27 @@
 set(CONFIG__KERNEL_STACK_SIZE		16*1024)
+set(CONFIG__TASK_STACK_SIZE		8*1024)
+set(CONFIG__IRQ_STACK_SIZE		16*1024)
 set(CONFIG__PAGE_SIZE			4096)
 
 set(CONFIG__MULTITASKING		y)
+set(CONFIG__SMP			y)
+set(CONFIG__MAX_CPUS			8)
 set(CONFIG__VERBOSE_TIMER_INTERRUPT	OFF)
+set(CONFIG__TICKLESS			y)
+set(CONFIG__LOCK_STATS			OFF)
+set(CONFIG__IRQ_LATENCY_TRACE		OFF)
+set(CONFIG__LOG_LEVEL			4)
+set(CONFIG__ASYNC_LOG			y)
+set(CONFIG__BINARY_LOG			y)
+set(CONFIG__LOG_VGA_LEVEL		5)
+set(CONFIG__LOG_SERIAL_LEVEL		5)
+set(CONFIG__LOG_DEBUGCON_LEVEL		5)
+set(CONFIG__LOG_DMESG_LEVEL		5)
+set(CONFIG__DMESG_SIZE			16*1024)
+set(CONFIG__DMESG_ON_PANIC		y)
+set(CONFIG__FRAMEBUFFER_CONSOLE		n)
+set(CONFIG__FRAMEBUFFER_WIDTH		1024)
+set(CONFIG__FRAMEBUFFER_HEIGHT		768)
 
 # For development needs
 set(CONFIG__HZ				10)
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint.hpp>
+#include <forward_list.hpp>
+
+
+namespace devices {
+
+
+/// \brief Clock event device.
+///
+/// Base class for timers that can raise interrupts at programmed moments,
+/// like PIT or local APIC timer. The kernel registers all available devices
+/// at boot and then uses the one with the highest rating as a source of
+/// timer events.
+class ClockEventDevice {
+public:
+	/// Features of clock event devices.
+	enum feature_t: uint32_t {
+		/// Device can raise events periodically.
+		periodic		= 1 << 0,
+		/// Device can raise single event after programmed delay.
+		oneshot			= 1 << 1,
+		/// Device is programmed with absolute TSC value.
+		tsc_deadline		= 1 << 2,
+	};
+
+
+	/// Type of event handler.
+	using event_handler_t = void (*)();
+
+
+	ClockEventDevice(const ClockEventDevice&) = delete;
+	ClockEventDevice(ClockEventDevice&&) = delete;
+	ClockEventDevice& operator =(const ClockEventDevice&) = delete;
+	ClockEventDevice& operator =(ClockEventDevice&&) = delete;
+
+	virtual ~ClockEventDevice() = default;
+
+
+	/// Name of the device.
+	virtual const char *name() const = 0;
+
+
+	/// \brief Rating of the device.
+	///
+	/// Device with higher rating is preferred.
+	virtual int rating() const = 0;
+
+
+	/// Bit mask of features supported by device. See \ref feature_t.
+	virtual uint32_t features() const = 0;
+
+
+	/// \brief Start periodic events.
+	///
+	/// \param hz Frequency of events.
+	virtual void set_periodic(uint32_t hz) = 0;
+
+
+	/// \brief Program single event.
+	///
+	/// \param delta_ns Delay till event in nanoseconds. Delays longer than
+	///	\ref max_delta_ns are truncated.
+	virtual void set_next_event(uint64_t delta_ns) = 0;
+
+
+	/// Maximal delay that can be programmed by \ref set_next_event.
+	virtual uint64_t max_delta_ns() const = 0;
+
+
+	/// Stop generating events.
+	virtual void shutdown() = 0;
+
+
+	/// Check if device supports given feature.
+	bool has_feature(feature_t feature) const {
+		return features() & feature;
+	}
+
+
+	/// Set function to be called on each event.
+	void set_event_handler(event_handler_t handler) {
+		_handler = handler;
+	}
+
+
+	/// \brief Register clock event device.
+	///
+	/// \warning Must be called before \ref select_best.
+	static void register_device(ClockEventDevice *device);
+
+
+	/// \brief Select the best registered device.
+	///
+	/// The function chooses device with the highest rating among
+	/// registered ones and shuts down the others.
+	///
+	/// \return Selected device or nullptr if no devices are registered.
+	static ClockEventDevice *select_best();
+
+protected:
+	ClockEventDevice() = default;
+
+
+	/// \brief Notify about event.
+	///
+	/// The function must be called by device's interrupt handler.
+	void event() {
+		if (_handler) {
+			_handler();
+		}
+	}
+
+private:
+	event_handler_t _handler{nullptr};
+
+	static lib::forward_list<ClockEventDevice *> _devices;
+};
+
+
+} // namespace devices
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint.hpp>
+
+#include <bolgenos-ng/vga_console.hpp>
+
+/// \brief Console on linear framebuffer.
+///
+/// The console draws characters with built-in 8x8 font scaled to 8x16
+/// pixels. It's used by \ref vga_console once \ref fb_console::init succeeds,
+/// so callers keep using \ref vga_console API.
+namespace fb_console {
+
+
+/// Description of direct color framebuffer.
+struct framebuffer_info {
+	uint32_t address;
+	uint32_t pitch;
+	uint32_t width;
+	uint32_t height;
+	/// Bits per pixel: 15, 16, 24 or 32.
+	uint8_t bpp;
+	uint8_t red_position;
+	uint8_t red_size;
+	uint8_t green_position;
+	uint8_t green_size;
+	uint8_t blue_position;
+	uint8_t blue_size;
+};
+
+
+/// \brief Start using framebuffer for console output.
+///
+/// \return false if pixel format isn't supported or framebuffer is too
+///	small for a single line of text.
+bool init(const framebuffer_info& info);
+
+
+/// Check if framebuffer console is used.
+bool is_active();
+
+
+/// \brief Print character.
+///
+/// The character is put to the cell grid and drawn on the next \ref flush.
+/// Line feed and carriage return move the cursor.
+void putc_color(char c, vga_console::color_t fg, vga_console::color_t bg);
+
+
+/// Fill the screen with specified colors.
+void clear(vga_console::color_t fg, vga_console::color_t bg);
+
+
+/// Draw changed cells and apply pending scrolling.
+void flush();
+
+
+} // namespace fb_console
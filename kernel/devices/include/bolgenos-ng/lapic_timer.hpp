@@ -0,0 +1,19 @@
+#pragma once
+
+
+namespace lapic_timer {
+
+
+/**
+* \brief Initialize local APIC timer.
+*
+* The function enables local APIC, calibrates its timer against PIT and
+* registers it as clock event device. If CPU supports TSC-deadline mode,
+* the timer is programmed with absolute TSC values.
+*
+* \warning This function should be called after \ref pit::init.
+*/
+void init();
+
+
+} // namespace lapic_timer
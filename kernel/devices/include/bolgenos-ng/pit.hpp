@@ -1,15 +1,31 @@
 #pragma once
 
+#include <cstdint.hpp>
+
 namespace pit {
 
+
+/// Duration of \ref calibration_wait in milliseconds.
+constexpr uint32_t CALIBRATION_MS = 50;
+
+
 /**
-* \brief Initialize PIT and timer subsystem.
+* \brief Initialize PIT.
 *
-* The function initializes PIT and timer subsystem and register timer interrupt
-* handler.
+* The function calibrates TSC-based monotonic clock against PIT and registers
+* PIT as clock event device.
 *
 * \warning This function should be calling before enabling interrupts.
 */
 void init();
 
+
+/**
+* \brief Wait for calibration period.
+*
+* The function busy-waits for \ref CALIBRATION_MS milliseconds measured by
+* channel 2 of PIT. It is used for calibration of other timers.
+*/
+void calibration_wait();
+
 } // napespace pit
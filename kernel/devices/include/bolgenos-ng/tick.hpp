@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint.hpp>
+
+
+/// Timer events subsystem.
+namespace tick {
+
+
+/**
+* \brief Initialize timer events.
+*
+* The function selects the best registered clock event device and starts
+* timer events. In tickless mode the device is programmed in one-shot mode
+* for the nearest requested deadline; otherwise it generates an event for
+* every jiffy.
+*
+* \warning This function should be calling before enabling interrupts.
+*/
+void init();
+
+
+/**
+* \brief Request timer event.
+*
+* The function asks the timer to raise an interrupt not later than at the
+* specified time of monotonic clock. In tickless mode the timer doesn't
+* generate interrupts that nobody waits for, so code that polls the clock
+* must request the event it waits for.
+*
+* \param deadline_ns Time to wake up at, see \ref time::now_ns.
+*/
+void request_event(uint64_t deadline_ns);
+
+
+/**
+* \brief Idle until the next timer event.
+*
+* The function halts CPU until the next interrupt. Since the timer is
+* programmed for the nearest requested deadline, CPU doesn't wake up for
+* ticks that nobody waits for.
+*/
+void idle();
+
+
+} // namespace tick
@@ -78,7 +78,8 @@ void clear_screen();
 * \brief Print character.
 *
 * Function prints one character to VGA console using current global background
-*	and foreground values.
+*	and foreground values. The character is put to the shadow buffer and
+*	appears on screen on the next \ref flush.
 * \param c Symbol to be printed.
 */
 void putc(char c);
@@ -88,7 +89,7 @@ void putc(char c);
 * \brief Print string.
 *
 * Function prints string to VGA console using current global background and
-*	foreground values.
+*	foreground values, and flushes the console.
 * \param str String to be printed.
 */
 void puts(const char* str);
@@ -98,7 +99,8 @@ void puts(const char* str);
 * \brief Print character.
 *
 * Function prints one character to VGA console using specified background and
-*	foreground colors.
+*	foreground colors. The character appears on screen on the next
+*	\ref flush.
 * \param c Symbol to be printed.
 * \param fg Foreground color.
 * \param bg Background color.
@@ -110,11 +112,21 @@ void putc_color(char c, color_t fg, color_t bg);
 * \brief Print string.
 *
 * Function prints string to VGA console using specified background and
-*	foreground colors.
+*	foreground colors, and flushes the console.
 * \param str String to be printed.
 * \param fg Foreground color.
 * \param bg Background color.
 */
 void puts_color(const char* str, color_t fg, color_t bg);
 
+
+/**
+* \brief Show pending output.
+*
+* Function copies changed lines of the shadow buffer to video memory, applies
+*	pending scrolling by moving CRTC start address and moves hardware
+*	cursor.
+*/
+void flush();
+
 } // namespace vga_console
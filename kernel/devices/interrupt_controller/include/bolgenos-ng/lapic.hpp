@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint.hpp>
+
+#include <bolgenos-ng/irq.hpp>
+
+
+/// Local APIC of the current CPU.
+namespace lapic {
+
+
+/// \brief Registers of local APIC.
+///
+/// Offsets of memory-mapped registers of local APIC.
+enum reg_t: uint32_t {
+	id			= 0x020,
+	version			= 0x030,
+	task_priority		= 0x080,
+	eoi			= 0x0b0,
+	spurious		= 0x0f0,
+	error_status		= 0x280,
+	icr_low			= 0x300,
+	icr_high		= 0x310,
+	lvt_timer		= 0x320,
+	lvt_error		= 0x370,
+	timer_initial		= 0x380,
+	timer_current		= 0x390,
+	timer_divide		= 0x3e0,
+};
+
+
+/// \brief Bits of local vector table entries.
+enum lvt_bits: uint32_t {
+	/// Interrupt is masked.
+	masked			= 1 << 16,
+	/// Timer: one-shot mode.
+	timer_oneshot		= 0 << 17,
+	/// Timer: periodic mode.
+	timer_periodic		= 1 << 17,
+	/// Timer: TSC-deadline mode.
+	timer_tsc_deadline	= 2 << 17,
+};
+
+
+/// \brief Bits of interrupt command register.
+enum icr_bits: uint32_t {
+	/// Fixed delivery mode.
+	icr_fixed		= 0 << 8,
+	/// INIT delivery mode.
+	icr_init		= 5 << 8,
+	/// Start-up delivery mode.
+	icr_startup		= 6 << 8,
+	/// Previous IPI hasn't been accepted yet.
+	icr_pending		= 1 << 12,
+	/// Level is asserted.
+	icr_assert		= 1 << 14,
+	/// Level-triggered interrupt.
+	icr_level		= 1 << 15,
+	/// Send to all CPUs excluding the sender.
+	icr_all_but_self	= 3 << 18,
+};
+
+
+/// Vector of local APIC timer interrupt.
+constexpr irq::irq_t timer_vector = 0xe0;
+
+
+/// Vector of IPI that asks CPU to look for tasks to run.
+constexpr irq::irq_t reschedule_vector = 0xf0;
+
+
+/// Vector of IPI that asks boot CPU to reprogram timer.
+constexpr irq::irq_t tick_vector = 0xf1;
+
+
+/// Vector of spurious interrupts of local APIC.
+constexpr irq::irq_t spurious_vector = 0xff;
+
+
+/// Check if CPU has local APIC.
+bool is_present();
+
+
+/// \brief Enable local APIC.
+///
+/// The function enables local APIC of the current CPU and accepts
+/// interrupts of all priorities.
+void enable();
+
+
+/// Check if local APIC has been enabled by \ref enable.
+bool is_enabled();
+
+
+/// Read register of local APIC.
+uint32_t read(reg_t reg);
+
+
+/// Write register of local APIC.
+void write(reg_t reg, uint32_t value);
+
+
+/// Send "End of interrupt" to local APIC.
+void end_of_interrupt();
+
+
+/// \brief Set task priority.
+///
+/// Local APIC delivers only interrupts whose priority class, i.e. vector / 16,
+/// is higher than the specified one. Class 0 enables all interrupts.
+///
+/// \param priority_class Priority class from 0 to 15.
+void set_task_priority(uint8_t priority_class);
+
+
+/// ID of local APIC of the current CPU.
+uint32_t apic_id();
+
+
+/// \brief Send inter-processor interrupt.
+///
+/// \param apic_id ID of local APIC of destination CPU.
+/// \param command Value of low part of interrupt command register, i.e.
+///	vector and delivery mode.
+void send_ipi(uint32_t apic_id, uint32_t command);
+
+
+/// Send fixed inter-processor interrupt to all other CPUs.
+void send_ipi_all_but_self(irq::irq_t vector);
+
+
+} // namespace lapic
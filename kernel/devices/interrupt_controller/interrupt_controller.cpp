@@ -1,11 +1,16 @@
 #include <bolgenos-ng/interrupt_controller.hpp>
 
+#include "ioapic.hpp"
 #include "pic_8259.hpp"
 
 devices::InterruptController *devices::InterruptController::instance()
 {
 	if (!_instance) {
-		_instance = new devices::PIC8259();
+		if (IOAPIC::is_present()) {
+			_instance = new devices::IOAPIC();
+		} else {
+			_instance = new devices::PIC8259();
+		}
 	}
 	return _instance;
 }
@@ -0,0 +1,261 @@
+#include "ioapic.hpp"
+
+#include "pic_8259.hpp"
+
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/lapic.hpp>
+#include <threading/with_lock.hpp>
+#include <x86/mp_config.hpp>
+
+#include <logger.hpp>
+
+LOCAL_LOGGER("ioapic", lib::LogLevel::INFO);
+
+
+namespace {
+
+
+/// Offsets of memory-mapped registers of I/O APIC.
+enum mmio_t: uint32_t {
+	/// Index of register to be accessed through \ref window.
+	select			= 0x00,
+	window			= 0x10,
+};
+
+
+/// Indirect registers of I/O APIC.
+enum reg_t: uint32_t {
+	version			= 0x01,
+	redirection_table	= 0x10,
+};
+
+
+/// \brief Bits of redirection entry.
+enum redirection_bits: uint32_t {
+	active_low		= 1 << 13,
+	level_triggered		= 1 << 15,
+	masked			= 1 << 16,
+};
+
+
+/// \brief Bits of MPS INTI flags of interrupt source override.
+enum inti_bits: uint16_t {
+	polarity_mask		= 0x3,
+	polarity_low		= 0x3,
+	trigger_mask		= 0xc,
+	trigger_level		= 0xc,
+};
+
+
+/// Vectors of ISA lines; are equal to ones used with 8259.
+constexpr irq::irq_t ISA_VECTOR_BASE = 0x20;
+
+
+uint32_t read(const x86::mp::ioapic_t& ioapic, uint32_t reg)
+{
+	auto base = reinterpret_cast<volatile uint32_t*>(ioapic.address);
+	base[mmio_t::select / sizeof(uint32_t)] = reg;
+	return base[mmio_t::window / sizeof(uint32_t)];
+}
+
+
+void write(const x86::mp::ioapic_t& ioapic, uint32_t reg, uint32_t value)
+{
+	auto base = reinterpret_cast<volatile uint32_t*>(ioapic.address);
+	base[mmio_t::select / sizeof(uint32_t)] = reg;
+	base[mmio_t::window / sizeof(uint32_t)] = value;
+}
+
+
+/// Number of redirection entries of I/O APIC.
+uint32_t entries_count(const x86::mp::ioapic_t& ioapic)
+{
+	return ((read(ioapic, reg_t::version) >> 16) & 0xff) + 1;
+}
+
+
+/// \brief Find I/O APIC that handles global system interrupt.
+///
+/// \return nullptr if there is no such I/O APIC.
+const x86::mp::ioapic_t* ioapic_of(uint32_t gsi)
+{
+	const auto& config = x86::mp::discover();
+	for (size_t i = 0; i < config.ioapics_count; ++i) {
+		const auto& ioapic = config.ioapics[i];
+		if (gsi >= ioapic.gsi_base
+				&& gsi < ioapic.gsi_base + entries_count(ioapic)) {
+			return &ioapic;
+		}
+	}
+	return nullptr;
+}
+
+
+/// \brief Find override of ISA line.
+///
+/// \return nullptr if the line is connected in the default way.
+const x86::mp::override_t* override_of(uint8_t line)
+{
+	const auto& config = x86::mp::discover();
+	for (size_t i = 0; i < config.overrides_count; ++i) {
+		if (config.overrides[i].source == line) {
+			return &config.overrides[i];
+		}
+	}
+	return nullptr;
+}
+
+
+/// \brief Check if input of I/O APIC is taken by override of another line.
+///
+/// E.g. PIT is usually connected to input 2, so ISA line 2 that is cascade
+/// of 8259 doesn't have an input.
+bool is_taken_by_override(uint32_t gsi)
+{
+	const auto& config = x86::mp::discover();
+	for (size_t i = 0; i < config.overrides_count; ++i) {
+		if (config.overrides[i].gsi == gsi
+				&& config.overrides[i].source != gsi) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/// Send "End of interrupt" for vector.
+void acknowledge(irq::irq_t vector)
+{
+	// Exceptions aren't delivered by local APIC, and spurious interrupts
+	// must not be acknowledged.
+	if (vector < ISA_VECTOR_BASE || vector == lapic::spurious_vector) {
+		return;
+	}
+	lapic::end_of_interrupt();
+}
+
+
+} // namespace
+
+
+bool devices::IOAPIC::is_present()
+{
+	return lapic::is_present() && x86::mp::discover().ioapics_count != 0;
+}
+
+
+int devices::IOAPIC::min_irq_vector() const
+{
+	return ISA_VECTOR_BASE;
+}
+
+
+void devices::IOAPIC::end_of_interrupt(irq::irq_t vector)
+{
+	acknowledge(vector);
+}
+
+
+void devices::IOAPIC::program_line(uint8_t line, uint32_t apic_id, bool masked)
+{
+	uint32_t gsi = line;
+	uint32_t flags = 0;
+	auto isa_override = override_of(line);
+	if (!isa_override && is_taken_by_override(gsi)) {
+		return;
+	}
+	if (isa_override) {
+		gsi = isa_override->gsi;
+		if ((isa_override->flags & inti_bits::polarity_mask)
+				== inti_bits::polarity_low) {
+			flags |= redirection_bits::active_low;
+		}
+		if ((isa_override->flags & inti_bits::trigger_mask)
+				== inti_bits::trigger_level) {
+			flags |= redirection_bits::level_triggered;
+		}
+	}
+
+	auto ioapic = ioapic_of(gsi);
+	if (!ioapic) {
+		return;
+	}
+
+	if (masked) {
+		flags |= redirection_bits::masked;
+	}
+
+	const uint32_t entry = redirection_table + 2 * (gsi - ioapic->gsi_base);
+	thr::with_lock(_lock, [&]() {
+		// Entry is masked while it's changed, so that interrupt isn't
+		// delivered with half-written entry.
+		write(*ioapic, entry, redirection_bits::masked);
+		write(*ioapic, entry + 1, apic_id << 24);
+		write(*ioapic, entry, flags | (ISA_VECTOR_BASE + line));
+	});
+}
+
+
+void devices::IOAPIC::initialize_controller()
+{
+	if (_controller_initialized) {
+		panic("Attempt to initialize IOAPIC twice!");
+	}
+
+	PIC8259::disable();
+
+	lapic::enable();
+	irq::InterruptsManager::instance()->set_end_of_interrupt(acknowledge);
+
+	const auto& config = x86::mp::discover();
+	for (size_t i = 0; i < config.ioapics_count; ++i) {
+		const auto& ioapic = config.ioapics[i];
+		const uint32_t count = entries_count(ioapic);
+		for (uint32_t entry = 0; entry < count; ++entry) {
+			write(ioapic, redirection_table + 2 * entry,
+				redirection_bits::masked);
+		}
+		LOG_INFO << "I/O APIC #" << ioapic.id << " handles interrupts "
+			<< ioapic.gsi_base << ".." << ioapic.gsi_base + count - 1
+			<< lib::endl;
+	}
+
+	const uint32_t boot_cpu = lapic::apic_id();
+	for (uint8_t line = 0; line < ISA_LINES; ++line) {
+		_destination[line] = boot_cpu;
+		_masked[line] = false;
+		program_line(line, _destination[line], _masked[line]);
+	}
+
+	_controller_initialized = true;
+}
+
+
+void devices::IOAPIC::route(uint8_t line, uint32_t apic_id)
+{
+	if (line >= ISA_LINES) {
+		panic("no such ISA line");
+	}
+	_destination[line] = apic_id;
+	program_line(line, apic_id, _masked[line]);
+}
+
+
+void devices::IOAPIC::mask(uint8_t line)
+{
+	if (line >= ISA_LINES) {
+		panic("no such ISA line");
+	}
+	_masked[line] = true;
+	program_line(line, _destination[line], true);
+}
+
+
+void devices::IOAPIC::unmask(uint8_t line)
+{
+	if (line >= ISA_LINES) {
+		panic("no such ISA line");
+	}
+	_masked[line] = false;
+	program_line(line, _destination[line], false);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <bolgenos-ng/interrupt_controller.hpp>
+
+#include <threading/spinlock.hpp>
+
+
+namespace devices {
+
+
+/// \brief Local APIC together with I/O APIC.
+///
+/// ISA interrupt lines are routed through redirection tables of I/O APICs to
+/// local APIC of the boot CPU, so that line N is delivered with vector
+/// min_irq_vector() + N as with 8259. Legacy 8259 is masked off.
+///
+/// Local APIC handles interrupts by priority classes, i.e. by vector / 16:
+/// ISA lines belong to classes 2 and 3, local APIC timer and IPIs have
+/// higher classes. See \ref lapic::set_task_priority.
+class IOAPIC: public devices::InterruptController {
+public:
+	IOAPIC(const IOAPIC&) = delete;
+	IOAPIC(IOAPIC&&) = delete;
+	IOAPIC& operator =(const IOAPIC&) = delete;
+	IOAPIC& operator =(IOAPIC&&) = delete;
+
+	virtual ~IOAPIC() = default;
+
+
+	/// Check if the system has I/O APIC and local APIC.
+	static bool is_present();
+
+
+	virtual int min_irq_vector() const;
+
+	virtual void initialize_controller();
+
+	virtual void end_of_interrupt(irq::irq_t vector);
+
+
+	/// \brief Route ISA line to CPU.
+	///
+	/// \param line ISA interrupt line.
+	/// \param apic_id ID of local APIC of destination CPU.
+	void route(uint8_t line, uint32_t apic_id);
+
+
+	/// Disable delivery of ISA line.
+	void mask(uint8_t line);
+
+
+	/// Enable delivery of ISA line.
+	void unmask(uint8_t line);
+
+protected:
+	IOAPIC() = default;
+
+private:
+	/// Number of ISA interrupt lines.
+	static constexpr uint8_t ISA_LINES = 16;
+
+	/// \brief Program redirection entry of ISA line.
+	///
+	/// \param line ISA interrupt line.
+	/// \param apic_id ID of local APIC of destination CPU.
+	/// \param masked Interrupt is masked.
+	void program_line(uint8_t line, uint32_t apic_id, bool masked);
+
+	bool _controller_initialized{false};
+	uint32_t _destination[ISA_LINES]{};
+	bool _masked[ISA_LINES]{};
+	thr::IrqSpinLock _lock{"ioapic"};
+
+	friend class InterruptController;
+};
+
+
+} // namespace devices
@@ -0,0 +1,154 @@
+#include <bolgenos-ng/lapic.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/irq_trace.hpp>
+
+#include <logger.hpp>
+
+LOCAL_LOGGER("lapic", lib::LogLevel::INFO);
+
+
+namespace {
+
+
+/// \brief Bits of IA32_APIC_BASE MSR.
+enum apic_base_bits: uint32_t {
+	/// APIC is globally enabled.
+	global_enable		= 1 << 11,
+	/// Mask of physical address of APIC registers.
+	base_mask		= 0xfffff000,
+};
+
+
+/// APIC software enable bit of spurious interrupt vector register.
+constexpr uint32_t SOFTWARE_ENABLE = 1 << 8;
+
+
+/// Address of memory-mapped registers.
+volatile uint8_t *apic_base = nullptr;
+
+
+/// \brief Handler of spurious interrupts.
+///
+/// Spurious interrupts don't require any actions.
+class SpuriousIRQHandler: public irq::IRQHandler {
+public:
+	status_t handle_irq(irq::irq_t vector __attribute__((unused))) override
+	{
+		return status_t::HANDLED;
+	}
+};
+
+
+} // namespace
+
+
+bool lapic::is_present()
+{
+	return x86::cpuid(1).edx & x86::cpuid_feature::edx_apic;
+}
+
+
+bool lapic::is_enabled()
+{
+	return apic_base != nullptr;
+}
+
+
+uint32_t lapic::read(reg_t reg)
+{
+	return *reinterpret_cast<volatile uint32_t *>(apic_base + reg);
+}
+
+
+void lapic::write(reg_t reg, uint32_t value)
+{
+	*reinterpret_cast<volatile uint32_t *>(apic_base + reg) = value;
+}
+
+
+void lapic::end_of_interrupt()
+{
+	write(reg_t::eoi, 0);
+}
+
+
+void lapic::set_task_priority(uint8_t priority_class)
+{
+	write(reg_t::task_priority, static_cast<uint32_t>(priority_class & 0xf) << 4);
+}
+
+
+uint32_t lapic::apic_id()
+{
+	return read(reg_t::id) >> 24;
+}
+
+
+namespace {
+
+
+void wait_for_delivery()
+{
+	while (lapic::read(lapic::icr_low) & lapic::icr_pending) {
+		x86::cpu_relax();
+	}
+}
+
+
+} // namespace
+
+
+void lapic::send_ipi(uint32_t apic_id, uint32_t command)
+{
+	const uint32_t flags = irq::trace::save_flags_and_cli();
+	wait_for_delivery();
+	write(reg_t::icr_high, apic_id << 24);
+	write(reg_t::icr_low, command);
+	wait_for_delivery();
+	irq::trace::restore_flags(flags);
+}
+
+
+void lapic::send_ipi_all_but_self(irq::irq_t vector)
+{
+	if (!is_enabled()) {
+		return;
+	}
+
+	const uint32_t flags = irq::trace::save_flags_and_cli();
+	wait_for_delivery();
+	write(reg_t::icr_low, icr_all_but_self | icr_assert | icr_fixed | vector);
+	wait_for_delivery();
+	irq::trace::restore_flags(flags);
+}
+
+
+void lapic::enable()
+{
+	if (!is_present()) {
+		panic("CPU has no local APIC");
+	}
+
+	if (!apic_base) {
+		irq::InterruptsManager::instance()->add_handler(spurious_vector,
+			new SpuriousIRQHandler());
+	}
+
+	uint32_t low, high;
+	read_msr(msr_ia32_apic_base, &low, &high);
+	if (!(low & apic_base_bits::global_enable)) {
+		low |= apic_base_bits::global_enable;
+		write_msr(msr_ia32_apic_base, low, high);
+	}
+
+	apic_base = reinterpret_cast<volatile uint8_t *>(low & apic_base_bits::base_mask);
+
+	set_task_priority(0);
+	write(reg_t::spurious, SOFTWARE_ENABLE | spurious_vector);
+
+	LOG_INFO << "enabled local APIC #" << apic_id()
+		<< " at " << static_cast<const void *>(const_cast<uint8_t *>(apic_base))
+		<< lib::endl;
+}
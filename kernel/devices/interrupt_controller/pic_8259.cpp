@@ -3,6 +3,7 @@
 #include <bolgenos-ng/asm.hpp>
 #include <bolgenos-ng/irq.hpp>
 #include <bolgenos-ng/error.h>
+#include <bolgenos-ng/lapic.hpp>
 
 
 namespace {
@@ -31,6 +32,26 @@ enum command_type: uint8_t {
 };
 
 
+/// Send "End of interrupt" for vector.
+void acknowledge(irq::irq_t vector)
+{
+	if (vector < 0x20 || vector >= 0x20 + 16) {
+		// Interrupts of local APIC, e.g. its timer, aren't routed
+		// through PIC.
+		if (vector != lapic::spurious_vector && lapic::is_enabled()) {
+			lapic::end_of_interrupt();
+		}
+		return;
+	}
+
+	if (vector >= 8 + 0x20) {
+		outb(port_type::slave_comm, command_type::end_of_interrupt);
+	}
+
+	outb(port_type::master_comm, command_type::end_of_interrupt);
+}
+
+
 } // namespace
 
 
@@ -42,19 +63,16 @@ int devices::PIC8259::min_irq_vector() const
 
 void devices::PIC8259::end_of_interrupt(irq::irq_t vector)
 {
-	if (vector > 8 + 0x20) {
-		outb(port_type::slave_comm, command_type::end_of_interrupt);
-	}
-
-	outb(port_type::master_comm, command_type::end_of_interrupt);
+	acknowledge(vector);
 }
 
 
-void devices::PIC8259::initialize_controller()
+namespace {
+
+
+/// Reinitialize 8259 with lines mapped to vectors starting from 0x20.
+void remap()
 {
-	if (_controller_initialized) {
-		panic("Attempt to initialize PIC8259 twice!");
-	}
 	int offset1 = 0x20;
 	int offset2 = 0x28;
 
@@ -69,9 +87,29 @@ void devices::PIC8259::initialize_controller()
 
 	outb(port_type::master_data, command_type::icw_4_8086);
 	outb(port_type::slave_data, command_type::icw_4_8086);
+}
+
 
+} // namespace
+
+
+void devices::PIC8259::initialize_controller()
+{
+	if (_controller_initialized) {
+		panic("Attempt to initialize PIC8259 twice!");
+	}
+
+	remap();
 	outb(port_type::master_data, 0x00);
+	irq::InterruptsManager::instance()->set_end_of_interrupt(acknowledge);
 
 	_controller_initialized = true;
 }
 
+
+void devices::PIC8259::disable()
+{
+	remap();
+	outb(port_type::master_data, 0xff);
+	outb(port_type::slave_data, 0xff);
+}
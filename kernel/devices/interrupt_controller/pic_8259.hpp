@@ -22,6 +22,13 @@ public:
 
 	virtual void end_of_interrupt(irq::irq_t vector);
 
+	/// \brief Disable 8259 in favour of another controller.
+	///
+	/// The function remaps lines of 8259 to vectors starting from 0x20
+	/// and masks all of them. Spurious interrupts that 8259 may raise even
+	/// with masked lines don't come to vectors of exceptions then.
+	static void disable();
+
 protected:
 	PIC8259()
 		: InterruptController(), _controller_initialized(false)
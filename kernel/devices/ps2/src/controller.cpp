@@ -338,17 +338,15 @@ void ps2::PS2Controller::send_command(ps2::cmd_t cmd)
 
 bool ps2::PS2Controller::wait_for_flag(status_reg_t flag, bool val, int ms) {
 	uint8_t st;
-	int wait = 0;
+	const uint64_t deadline = time::now_ns() + ms * time::NSEC_PER_MSEC;
 	if (val) {
 		while (!((st = status()) & flag)
-				&& wait < ms) {
-			++wait;
+				&& time::now_ns() < deadline) {
 			sleep_ms(1 /* ms */);
 		}
 	} else {
 		while (((st = status()) & flag)
-				&& wait < ms) {
-			++wait;
+				&& time::now_ns() < deadline) {
 			sleep_ms(1 /* ms */);
 		}
 	}
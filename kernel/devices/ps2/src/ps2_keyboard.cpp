@@ -63,11 +63,31 @@ ok:
 
 irq::IRQHandler::status_t ps2::keyboard::PS2DefaultKeyboard::handle_irq() {
 	uint8_t byte = ps2::PS2Controller::instance()->receive_byte();
-	_sm.handle_byte(byte);
+
+	if (!_scancodes.try_push(byte)) {
+		++_dropped_scancodes;
+	}
+
+	sched::WorkQueue::system().queue(&_work);
 	return irq::IRQHandler::status_t::HANDLED;
 }
 
 
+void ps2::keyboard::PS2DefaultKeyboard::process_scancodes(void* keyboard) {
+	auto self = static_cast<PS2DefaultKeyboard*>(keyboard);
+
+	const uint32_t dropped = self->_dropped_scancodes.exchange(0);
+	if (dropped) {
+		self->WARN << "dropped " << dropped << " scancodes" << endl;
+	}
+
+	uint8_t byte;
+	while (self->_scancodes.try_pop(byte)) {
+		self->_sm.handle_byte(byte);
+	}
+}
+
+
 void ps2::keyboard::init() {
 	static ps2::keyboard::PS2DefaultKeyboard ps2_kbd;
 	ps2::PS2Controller::instance()->register_driver(&ps2_kbd);
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic.hpp>
+#include <ext/ring.hpp>
 #include <loggable.hpp>
 #include <ps2/device.hpp>
 #include <bolgenos-ng/keyboard.hpp>
+#include <sched/work_queue.hpp>
 
 #include "ps2_keyboard_sm.hpp"
 
@@ -19,7 +22,7 @@ enum class key_status_t {
 class PS2DefaultKeyboard: public ps2::IPS2Device, private Loggable("ps2.kb.default") {
 public:
 	PS2DefaultKeyboard()
-			: _sm(this)
+			: _sm(this), _work(process_scancodes, this)
 	{
 		for (auto& status : key_statuses_) {
 			status = key_status_t::released;
@@ -36,8 +39,21 @@ public:
 		return key_statuses_[idx];
 	}
 private:
+	/// Number of scancodes that may be received before processing.
+	static constexpr uint32_t SCANCODES_BUFFER_SIZE = 32;
+
+	/// \brief Process received scancodes.
+	///
+	/// Scancodes are passed through keyboard state machine by worker
+	/// task rather than by interrupt handler.
+	static void process_scancodes(void* keyboard);
+
 	ps2_kbd_impl::KbdStateMachine _sm;
 	key_status_t key_statuses_[__kb_key_max];
+
+	sched::Work _work;
+	lib::SpscRing<uint8_t, SCANCODES_BUFFER_SIZE> _scancodes{};
+	lib::atomic<uint32_t> _dropped_scancodes{0};
 };
 
 // \brief Initilize PS/2 keyboard driver.
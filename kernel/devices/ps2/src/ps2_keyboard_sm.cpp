@@ -1,7 +1,11 @@
 #include "ps2_keyboard_sm.hpp"
 
+#include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/irq_trace.hpp>
 #include <bolgenos-ng/keyboard.hpp>
 #include <bolgenos-ng/vga_console.hpp>
+#include <log/dmesg.hpp>
+#include <log/serial_console.hpp>
 
 #include "ps2_keyboard.hpp"
 
@@ -151,6 +155,18 @@ handle_status_t PrintState::handle_byte(uint8_t byte __attribute__((unused)))
 			}
 		}
 	}
+	vga_console::flush();
+
+	if (device->key(kb_key_f12) == key_status_t::pressed) {
+		irq::InterruptsManager::instance()->print_stats(log::serial_console());
+		irq::trace::print(log::serial_console());
+		device->key(kb_key_f12) = key_status_t::released;
+	}
+
+	if (device->key(kb_key_f11) == key_status_t::pressed) {
+		log::dmesg::dump(log::serial_console());
+		device->key(kb_key_f11) = key_status_t::released;
+	}
 
 	_machine->set_state(_machine->wait_state());
 	return handle_status_t::done;
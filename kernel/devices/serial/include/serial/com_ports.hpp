@@ -11,4 +11,10 @@ enum class ComPort: lib::uint16_t {
 	COM4 = 0x2E8,
 };
 
+
+/// ISA interrupt line of the port.
+constexpr uint8_t isa_line(ComPort port) {
+	return (port == ComPort::COM1 || port == ComPort::COM3) ? 4 : 3;
+}
+
 }
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic.hpp>
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+#include <ext/ring.hpp>
+
+#include <bolgenos-ng/irq.hpp>
+#include <threading/spinlock.hpp>
+
+#include "com_ports.hpp"
+#include "io_ports.hpp"
+#include "serial_port.hpp"
+
+namespace serial {
+
+
+/// \brief Driver of 16550 UART.
+///
+/// Until \ref enable_interrupts is called, characters are written by polling
+/// line status, so the driver may be used at early boot. After that written
+/// characters are put into transmit ring and THR-empty interrupt refills
+/// transmit FIFO from it; received characters are collected by receive
+/// interrupt into receive ring. Writers spin only if the transmit ring is
+/// full.
+class Uart: public irq::IRQHandler {
+public:
+	/// Size of transmit ring.
+	static constexpr size_t TX_BUFFER_SIZE = 4096;
+
+	/// Size of receive ring.
+	static constexpr size_t RX_BUFFER_SIZE = 256;
+
+	explicit Uart(ComPort port);
+
+	Uart(const Uart&) = delete;
+	Uart& operator=(const Uart&) = delete;
+
+	/// UART of COM1 port.
+	static Uart& com1();
+
+	/// \brief Number of characters written to transmit FIFO at once.
+	///
+	/// 16 for 16550A and 1 for UARTs without working FIFO.
+	[[nodiscard]]
+	size_t fifo_size() const { return _fifo_size; }
+
+	/// \brief Start interrupt-driven operation.
+	///
+	/// \param vector Interrupt vector of the port.
+	void enable_interrupts(irq::irq_t vector);
+
+	/// \brief Return to polling.
+	///
+	/// Function writes all buffered characters by polling; it's used on
+	/// panic, when interrupts won't come anymore.
+	void stop_interrupts();
+
+	void write(char c);
+
+	/// \brief Take received character.
+	///
+	/// \return false if there is no received character.
+	bool read(char& c);
+
+	/// Number of received characters that didn't fit into receive ring.
+	[[nodiscard]]
+	uint32_t rx_dropped() const { return _rx_dropped.load(); }
+
+	status_t handle_irq(irq::irq_t vector) override;
+
+private:
+	void write_polled(char c);
+	void fill_fifo();
+	void start_transmit();
+	void transmit();
+	void receive();
+	void set_interrupts(uint8_t ier);
+
+	const IOPorts _ports;
+	SerialPort _port;
+	size_t _fifo_size{1};
+
+	/// Characters are passed via rings and interrupts.
+	lib::atomic<bool> _buffered{false};
+
+	/// Lock of transmit ring and of enabled interrupts.
+	thr::IrqSpinLock _tx_lock{"uart"};
+	lib::SpscRing<char, TX_BUFFER_SIZE> _tx{};
+	uint8_t _ier{0};
+
+	lib::SpscRing<char, RX_BUFFER_SIZE> _rx{};
+	lib::atomic<uint32_t> _rx_dropped{0};
+};
+
+
+} // namespace serial
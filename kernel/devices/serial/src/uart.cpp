@@ -0,0 +1,238 @@
+#include <serial/uart.hpp>
+
+#include <mutex.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/error.h>
+
+#include <serial/lsr.hpp>
+
+namespace {
+
+
+/// Bits of Interrupt Enable Register.
+enum ier_bits: uint8_t {
+	ier_rx_data		= 1 << 0,
+	ier_tx_empty		= 1 << 1,
+	ier_line_status		= 1 << 2,
+};
+
+
+/// Bits of FIFO Control Register; it shares port with Interrupt ID Register.
+enum fcr_bits: uint8_t {
+	fcr_enable		= 1 << 0,
+	fcr_clear_rx		= 1 << 1,
+	fcr_clear_tx		= 1 << 2,
+	/// Receive interrupt is raised when 14 bytes are in FIFO.
+	fcr_rx_trigger_14	= 3 << 6,
+};
+
+
+/// Bits of Interrupt Identification Register.
+enum iir_bits: uint8_t {
+	iir_no_interrupt	= 1 << 0,
+	iir_id_mask		= 7 << 1,
+	iir_modem_status	= 0 << 1,
+	iir_tx_empty		= 1 << 1,
+	iir_rx_data		= 2 << 1,
+	iir_line_status		= 3 << 1,
+	iir_rx_timeout		= 6 << 1,
+	/// Both bits are set only if FIFO is enabled and works.
+	iir_fifo_mask		= 3 << 6,
+};
+
+
+/// Bits of Modem Control Register.
+enum mcr_bits: uint8_t {
+	mcr_dtr			= 1 << 0,
+	mcr_rts			= 1 << 1,
+	/// Connects interrupt output of UART to interrupt controller.
+	mcr_out2		= 1 << 3,
+};
+
+
+/// Size of transmit FIFO of 16550A.
+constexpr size_t FIFO_16550A_SIZE = 16;
+
+
+} // namespace
+
+
+serial::Uart::Uart(ComPort port)
+	: _ports{port}, _port{port}
+{
+	outb(_ports.ENABLE_INTERRUPT, 0);
+	outb(_ports.INTERRUPT_ID,
+		fcr_enable | fcr_clear_rx | fcr_clear_tx | fcr_rx_trigger_14);
+	if ((inb(_ports.INTERRUPT_ID) & iir_fifo_mask) == iir_fifo_mask) {
+		_fifo_size = FIFO_16550A_SIZE;
+	} else {
+		outb(_ports.INTERRUPT_ID, 0);
+	}
+	outb(_ports.MCR, mcr_dtr | mcr_rts);
+}
+
+
+serial::Uart& serial::Uart::com1()
+{
+	static Uart uart{ComPort::COM1};
+	return uart;
+}
+
+
+void serial::Uart::enable_interrupts(irq::irq_t vector)
+{
+	irq::InterruptsManager::instance()->add_handler(vector, this);
+	add_panic_notifier([]() { com1().stop_interrupts(); });
+
+	lib::lock_guard guard{_tx_lock};
+	outb(_ports.MCR, mcr_dtr | mcr_rts | mcr_out2);
+	set_interrupts(ier_rx_data | ier_line_status);
+	_buffered.store(true);
+	start_transmit();
+}
+
+
+void serial::Uart::stop_interrupts()
+{
+	// The lock isn't taken: on panic it may be held forever.
+	if (!_buffered.exchange(false)) {
+		return;
+	}
+	set_interrupts(0);
+	char c;
+	while (_tx.try_pop(c)) {
+		write_polled(c);
+	}
+}
+
+
+void serial::Uart::write(char c)
+{
+	if (!_buffered.load(lib::memory_order_relaxed)) {
+		write_polled(c);
+		return;
+	}
+
+	lib::lock_guard guard{_tx_lock};
+	while (!_tx.try_push(c)) {
+		// The ring is full, so the oldest character is written here to
+		// free a slot.
+		char oldest;
+		if (_tx.try_pop(oldest)) {
+			write_polled(oldest);
+		}
+	}
+	if (!(_ier & ier_tx_empty)) {
+		start_transmit();
+	}
+}
+
+
+bool serial::Uart::read(char& c)
+{
+	if (_buffered.load(lib::memory_order_relaxed)) {
+		return _rx.try_pop(c);
+	}
+
+	LineStatusRegister lsr = inb(_ports.LSR);
+	if (!lsr.data_ready) {
+		return false;
+	}
+	c = static_cast<char>(inb(_ports.DATA));
+	return true;
+}
+
+
+irq::IRQHandler::status_t serial::Uart::handle_irq(irq::irq_t)
+{
+	auto status = status_t::NONE;
+	while (true) {
+		const uint8_t iir = inb(_ports.INTERRUPT_ID);
+		if (iir & iir_no_interrupt) {
+			return status;
+		}
+		status = status_t::HANDLED;
+
+		switch (iir & iir_id_mask) {
+		case iir_tx_empty:
+			transmit();
+			break;
+		case iir_rx_data:
+		case iir_rx_timeout:
+			receive();
+			break;
+		case iir_line_status:
+			inb(_ports.LSR);
+			break;
+		default:
+			inb(_ports.MSR);
+			break;
+		}
+	}
+}
+
+
+void serial::Uart::write_polled(char c)
+{
+	_port.write(c);
+}
+
+
+/// Move characters from transmit ring to FIFO if the FIFO is empty.
+void serial::Uart::fill_fifo()
+{
+	LineStatusRegister lsr = inb(_ports.LSR);
+	if (!lsr.can_send) {
+		return;
+	}
+	char c;
+	for (size_t i = 0; i < _fifo_size && _tx.try_pop(c); ++i) {
+		outb(_ports.DATA, c);
+	}
+}
+
+
+/// \brief Start transmission of transmit ring.
+///
+/// THR-empty interrupt is enabled while the ring isn't empty. Must be called
+/// with transmit lock held.
+void serial::Uart::start_transmit()
+{
+	fill_fifo();
+	if (!_tx.empty()) {
+		set_interrupts(_ier | ier_tx_empty);
+	}
+}
+
+
+void serial::Uart::transmit()
+{
+	lib::lock_guard guard{_tx_lock};
+	fill_fifo();
+	if (_tx.empty()) {
+		set_interrupts(_ier & ~ier_tx_empty);
+	}
+}
+
+
+void serial::Uart::receive()
+{
+	while (true) {
+		LineStatusRegister lsr = inb(_ports.LSR);
+		if (!lsr.data_ready) {
+			break;
+		}
+		const char c = static_cast<char>(inb(_ports.DATA));
+		if (!_rx.try_push(c)) {
+			_rx_dropped.fetch_add(1, lib::memory_order_relaxed);
+		}
+	}
+}
+
+
+void serial::Uart::set_interrupts(uint8_t ier)
+{
+	_ier = ier;
+	outb(_ports.ENABLE_INTERRUPT, ier);
+}
@@ -0,0 +1,42 @@
+#include <bolgenos-ng/clock_event.hpp>
+
+#include <bolgenos-ng/error.h>
+
+#include <logger.hpp>
+
+LOCAL_LOGGER("clockevents", lib::LogLevel::INFO);
+
+
+lib::forward_list<devices::ClockEventDevice *> devices::ClockEventDevice::_devices{};
+
+
+void devices::ClockEventDevice::register_device(ClockEventDevice *device)
+{
+	if (_devices.push_front(device) == _devices.end()) {
+		panic("failed to register clock event device");
+	}
+	LOG_INFO << "registered " << device->name()
+		<< " (rating " << device->rating() << ")" << lib::endl;
+}
+
+
+devices::ClockEventDevice *devices::ClockEventDevice::select_best()
+{
+	ClockEventDevice *best = nullptr;
+	for (auto device: _devices) {
+		if (!best || device->rating() > best->rating()) {
+			best = device;
+		}
+	}
+
+	for (auto device: _devices) {
+		if (device != best) {
+			device->shutdown();
+		}
+	}
+
+	if (best) {
+		LOG_NOTICE << "using " << best->name() << lib::endl;
+	}
+	return best;
+}
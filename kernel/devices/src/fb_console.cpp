@@ -0,0 +1,244 @@
+#include <bolgenos-ng/fb_console.hpp>
+
+#include <algorithm.hpp>
+#include <cstring.hpp>
+
+#include "fb_font.hpp"
+
+using vga_console::color_t;
+
+namespace {
+
+
+/// Height of character cell: every font line is drawn twice.
+constexpr int CELL_HEIGHT = fb_console::FONT_HEIGHT * 2;
+constexpr int CELL_WIDTH = fb_console::FONT_WIDTH;
+
+
+/// Maximal size of the cell grid; it's enough for 1920x1200 framebuffer.
+/// Larger framebuffer is used partially.
+constexpr int MAX_COLUMNS = 240;
+constexpr int MAX_ROWS = 75;
+
+
+struct cell_t {
+	char ch;
+	/// Foreground color in low nibble, background one in high nibble.
+	uint8_t attr;
+};
+
+
+bool active = false;
+
+uint8_t *fb = nullptr;
+uint32_t pitch = 0;
+uint32_t bytes_per_pixel = 0;
+int columns = 0, rows = 0;
+
+/// Pixel values of \ref vga_console::color_t.
+uint32_t palette[16];
+
+
+/// \brief Characters shown on screen.
+///
+/// Rows are kept in a ring: row 0 is `cells[cells_top]`.
+cell_t cells[MAX_ROWS][MAX_COLUMNS];
+int cells_top = 0;
+
+int cursor_row = 0, cursor_column = 0;
+
+
+/// \brief Rectangle of cells that differ from framebuffer.
+///
+/// Bounds are inclusive; the rectangle is empty if dirty_top > dirty_bottom.
+int dirty_top = MAX_COLUMNS, dirty_bottom = -1;
+int dirty_left = MAX_COLUMNS, dirty_right = -1;
+
+/// Number of scrolls since the last flush.
+int pending_scroll = 0;
+
+
+/// Standard VGA palette as 0xRRGGBB.
+constexpr uint32_t vga_rgb[16] = {
+	0x000000, 0x0000aa, 0x00aa00, 0x00aaaa,
+	0xaa0000, 0xaa00aa, 0xaa5500, 0xaaaaaa,
+	0x555555, 0x5555ff, 0x55ff55, 0x55ffff,
+	0xff5555, 0xff55ff, 0xffff55, 0xffffff,
+};
+
+
+uint32_t channel(uint32_t rgb, int shift, uint8_t position, uint8_t size) {
+	const uint32_t value = (rgb >> shift) & 0xff;
+	return size > 8 ? value << (position + size - 8)
+		: (value >> (8 - size)) << position;
+}
+
+
+cell_t *row_cells(int row) {
+	return cells[(cells_top + row) % MAX_ROWS];
+}
+
+
+void reset_dirty() {
+	dirty_top = dirty_left = MAX_COLUMNS;
+	dirty_bottom = dirty_right = -1;
+}
+
+
+void mark_dirty(int row, int left, int right) {
+	dirty_top = lib::min(dirty_top, row);
+	dirty_bottom = lib::max(dirty_bottom, row);
+	dirty_left = lib::min(dirty_left, left);
+	dirty_right = lib::max(dirty_right, right);
+}
+
+
+void mark_all_dirty() {
+	dirty_top = 0;
+	dirty_bottom = rows - 1;
+	dirty_left = 0;
+	dirty_right = columns - 1;
+}
+
+
+void scroll() {
+	cells_top = (cells_top + 1) % MAX_ROWS;
+	const cell_t empty = {' ', static_cast<uint8_t>(vga_console::get_fg()
+		| (vga_console::get_bg() << 4))};
+	lib::fill_n(row_cells(rows - 1), columns, empty);
+
+	// The dirty rectangle moves up together with text.
+	if (dirty_top <= dirty_bottom) {
+		dirty_top = lib::max(dirty_top - 1, 0);
+		if (--dirty_bottom < dirty_top) {
+			reset_dirty();
+		}
+	}
+	mark_dirty(rows - 1, 0, columns - 1);
+	++pending_scroll;
+}
+
+
+void line_break() {
+	cursor_column = 0;
+	if (++cursor_row == rows) {
+		cursor_row = rows - 1;
+		scroll();
+	}
+}
+
+
+/// \brief Draw single cell.
+///
+/// Every pixel of glyph line is selected from foreground and background
+/// without branches. The line is composed in a local buffer and copied to
+/// framebuffer at once, so 16 and 24 bpp pixels are packed the same way.
+void draw_cell(int row, int column, const cell_t& cell) {
+	const auto ch = static_cast<uint8_t>(cell.ch);
+	const int glyph = ch >= fb_console::FONT_FIRST
+		&& ch < fb_console::FONT_FIRST + fb_console::FONT_GLYPHS
+		? ch - fb_console::FONT_FIRST : '?' - fb_console::FONT_FIRST;
+	const uint32_t bg = palette[cell.attr >> 4];
+	const uint32_t diff = palette[cell.attr & 0xf] ^ bg;
+
+	const size_t line_size = CELL_WIDTH * bytes_per_pixel;
+	uint8_t *line = fb + row * CELL_HEIGHT * pitch + column * line_size;
+	for (int y = 0; y < fb_console::FONT_HEIGHT; ++y) {
+		const uint32_t bits = fb_console::font[glyph][y];
+		// Every pixel is stored as 32-bit word; the next pixel overwrites
+		// its unused high bytes.
+		uint8_t pixels[CELL_WIDTH * sizeof(uint32_t)];
+		for (int x = 0; x < CELL_WIDTH; ++x) {
+			const uint32_t pixel = bg ^ (diff & -((bits >> x) & 1));
+			memcpy(pixels + x * bytes_per_pixel, &pixel, sizeof(pixel));
+		}
+		memcpy(line, pixels, line_size);
+		memcpy(line + pitch, pixels, line_size);
+		line += 2 * pitch;
+	}
+}
+
+
+} // namespace
+
+
+bool fb_console::init(const framebuffer_info& info) {
+	if (info.bpp != 15 && info.bpp != 16 && info.bpp != 24 && info.bpp != 32) {
+		return false;
+	}
+	if (info.width < CELL_WIDTH || info.height < 2 * CELL_HEIGHT) {
+		return false;
+	}
+
+	fb = reinterpret_cast<uint8_t *>(info.address);
+	pitch = info.pitch;
+	bytes_per_pixel = (info.bpp + 7) / 8;
+	columns = lib::min<int>(info.width / CELL_WIDTH, MAX_COLUMNS);
+	rows = lib::min<int>(info.height / CELL_HEIGHT, MAX_ROWS);
+	for (int i = 0; i < 16; ++i) {
+		palette[i] = channel(vga_rgb[i], 16, info.red_position,
+				info.red_size)
+			| channel(vga_rgb[i], 8, info.green_position,
+				info.green_size)
+			| channel(vga_rgb[i], 0, info.blue_position,
+				info.blue_size);
+	}
+	active = true;
+	return true;
+}
+
+
+bool fb_console::is_active() {
+	return active;
+}
+
+
+void fb_console::putc_color(char c, color_t fg, color_t bg) {
+	switch (c) {
+	case '\n':
+		line_break();
+		break;
+	case '\r':
+		cursor_column = 0;
+		break;
+	default:
+		row_cells(cursor_row)[cursor_column] = {c,
+			static_cast<uint8_t>(fg | (bg << 4))};
+		mark_dirty(cursor_row, cursor_column, cursor_column);
+		if (++cursor_column == columns) {
+			line_break();
+		}
+	}
+}
+
+
+void fb_console::clear(color_t fg, color_t bg) {
+	const cell_t empty = {' ', static_cast<uint8_t>(fg | (bg << 4))};
+	for (int row = 0; row < rows; ++row) {
+		lib::fill_n(row_cells(row), columns, empty);
+	}
+	cursor_row = cursor_column = 0;
+	pending_scroll = 0;
+	mark_all_dirty();
+	flush();
+}
+
+
+void fb_console::flush() {
+	if (pending_scroll >= rows) {
+		mark_all_dirty();
+	} else if (pending_scroll) {
+		const size_t shift = pending_scroll * CELL_HEIGHT * pitch;
+		memmove(fb, fb + shift,
+			(rows - pending_scroll) * CELL_HEIGHT * pitch);
+	}
+	pending_scroll = 0;
+
+	for (int row = dirty_top; row <= dirty_bottom; ++row) {
+		const cell_t *line = row_cells(row);
+		for (int column = dirty_left; column <= dirty_right; ++column) {
+			draw_cell(row, column, line[column]);
+		}
+	}
+	reset_dirty();
+}
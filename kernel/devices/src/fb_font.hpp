@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint.hpp>
+
+namespace fb_console {
+
+
+/// First character that has glyph.
+constexpr char FONT_FIRST = ' ';
+
+/// Number of glyphs: printable ASCII characters.
+constexpr int FONT_GLYPHS = 95;
+
+/// Width of glyph in pixels.
+constexpr int FONT_WIDTH = 8;
+
+/// Height of glyph in font lines.
+constexpr int FONT_HEIGHT = 8;
+
+
+/// Built-in bitmap font.
+extern const uint8_t font[FONT_GLYPHS][FONT_HEIGHT];
+
+
+} // namespace fb_console
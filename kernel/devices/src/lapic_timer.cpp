@@ -0,0 +1,205 @@
+#include <bolgenos-ng/lapic_timer.hpp>
+
+#include <algorithm.hpp>
+#include <cstdint.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/clock_event.hpp>
+#include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/lapic.hpp>
+#include <bolgenos-ng/pit.hpp>
+#include <bolgenos-ng/time.hpp>
+
+#include <logger.hpp>
+
+LOCAL_LOGGER("lapic_timer", lib::LogLevel::INFO);
+
+
+namespace {
+
+
+/// Value of divide configuration register that divides bus clock by 16.
+constexpr uint32_t DIVIDE_BY_16 = 0x3;
+
+
+/// Shift of fixed-point multiplier of nanoseconds to timer ticks.
+constexpr unsigned TICKS_SHIFT = 24;
+
+
+/// Maximal delay of event in TSC-deadline mode.
+constexpr uint64_t MAX_DEADLINE_NS = 10 * time::NSEC_PER_SEC;
+
+
+/// \brief Local APIC timer as clock event device.
+class LapicClockEvent: public devices::ClockEventDevice, public irq::IRQHandler {
+public:
+	LapicClockEvent(const LapicClockEvent&) = delete;
+	LapicClockEvent(LapicClockEvent&&) = delete;
+	LapicClockEvent& operator =(const LapicClockEvent&) = delete;
+	LapicClockEvent& operator =(LapicClockEvent&&) = delete;
+
+
+	/// \brief Constructor.
+	///
+	/// \param khz Calibrated frequency of timer ticks.
+	/// \param tsc_deadline Use TSC-deadline mode for one-shot events.
+	LapicClockEvent(uint32_t khz, bool tsc_deadline)
+		: _khz(khz), _tsc_deadline(tsc_deadline)
+	{
+		uint64_t mult = static_cast<uint64_t>(khz) << TICKS_SHIFT;
+		x86::div64(mult, time::NSEC_PER_MSEC);
+		_ns_mult = static_cast<uint32_t>(mult);
+
+		uint64_t max_delta = 0xffffffffull * time::NSEC_PER_MSEC;
+		x86::div64(max_delta, khz);
+		_max_delta_ns = max_delta;
+	}
+
+	virtual ~LapicClockEvent() {}
+
+
+	const char *name() const override
+	{
+		return _tsc_deadline ? "lapic-tsc-deadline" : "lapic";
+	}
+
+
+	int rating() const override
+	{
+		return _tsc_deadline ? 110 : 100;
+	}
+
+
+	uint32_t features() const override
+	{
+		uint32_t features = feature_t::periodic | feature_t::oneshot;
+		if (_tsc_deadline) {
+			features |= feature_t::tsc_deadline;
+		}
+		return features;
+	}
+
+
+	void set_periodic(uint32_t hz) override
+	{
+		lapic::write(lapic::timer_divide, DIVIDE_BY_16);
+		lapic::write(lapic::lvt_timer, lapic::timer_periodic | lapic::timer_vector);
+		lapic::write(lapic::timer_initial, _khz * 1000 / hz);
+		_lvt_mode = lapic::timer_periodic;
+	}
+
+
+	void set_next_event(uint64_t delta_ns) override
+	{
+		delta_ns = lib::min(delta_ns, max_delta_ns());
+
+		if (_tsc_deadline) {
+			set_lvt_mode(lapic::timer_tsc_deadline);
+			const uint64_t deadline = x86::read_tsc()
+				+ time::ns_to_cycles(delta_ns) + 1;
+			write_msr(msr_ia32_tsc_deadline,
+				static_cast<uint32_t>(deadline),
+				static_cast<uint32_t>(deadline >> 32));
+			return;
+		}
+
+		set_lvt_mode(lapic::timer_oneshot);
+		const uint64_t ticks = x86::mul_shr(delta_ns, _ns_mult, TICKS_SHIFT);
+		lapic::write(lapic::timer_initial,
+			static_cast<uint32_t>(lib::min<uint64_t>(ticks + 1, 0xffffffff)));
+	}
+
+
+	uint64_t max_delta_ns() const override
+	{
+		return _tsc_deadline ? MAX_DEADLINE_NS : _max_delta_ns;
+	}
+
+
+	void shutdown() override
+	{
+		lapic::write(lapic::lvt_timer, lapic::masked | lapic::timer_vector);
+		lapic::write(lapic::timer_initial, 0);
+		_lvt_mode = lapic::masked;
+	}
+
+
+	status_t handle_irq(irq::irq_t vector __attribute__((unused))) override
+	{
+		event();
+		return status_t::HANDLED;
+	}
+
+private:
+	void set_lvt_mode(uint32_t mode)
+	{
+		if (_lvt_mode == mode) {
+			return;
+		}
+		lapic::write(lapic::timer_divide, DIVIDE_BY_16);
+		lapic::write(lapic::lvt_timer, mode | lapic::timer_vector);
+		_lvt_mode = mode;
+	}
+
+
+	/// Frequency of timer ticks.
+	uint32_t _khz;
+
+	/// Nanoseconds to ticks multiplier.
+	uint32_t _ns_mult{0};
+
+	/// Maximal delay of one-shot event.
+	uint64_t _max_delta_ns{0};
+
+	/// One-shot events are programmed in TSC-deadline mode.
+	bool _tsc_deadline;
+
+	/// Current mode of timer's local vector table entry.
+	uint32_t _lvt_mode{lapic::masked};
+};
+
+
+/// \brief Calibrate local APIC timer.
+///
+/// \return Frequency of timer ticks in kHz.
+uint32_t calibrate()
+{
+	lapic::write(lapic::timer_divide, DIVIDE_BY_16);
+	lapic::write(lapic::lvt_timer, lapic::masked | lapic::timer_vector);
+	lapic::write(lapic::timer_initial, 0xffffffff);
+
+	pit::calibration_wait();
+
+	const uint32_t elapsed = 0xffffffff - lapic::read(lapic::timer_current);
+	lapic::write(lapic::timer_initial, 0);
+
+	return elapsed / pit::CALIBRATION_MS;
+}
+
+
+} // namespace
+
+
+void lapic_timer::init()
+{
+	if (!lapic::is_present()) {
+		LOG_NOTICE << "CPU has no local APIC" << lib::endl;
+		return;
+	}
+
+	lapic::enable();
+
+	const uint32_t khz = calibrate();
+	if (!khz) {
+		LOG_WARN << "local APIC timer doesn't tick" << lib::endl;
+		return;
+	}
+
+	const bool tsc_deadline = x86::cpuid(1).ecx & x86::cpuid_feature::ecx_tsc_deadline;
+	LOG_NOTICE << "timer frequency: " << khz << " kHz"
+		<< (tsc_deadline ? ", TSC-deadline mode" : "") << lib::endl;
+
+	auto timer = new LapicClockEvent(khz, tsc_deadline);
+	irq::InterruptsManager::instance()->add_handler(lapic::timer_vector, timer);
+	devices::ClockEventDevice::register_device(timer);
+}
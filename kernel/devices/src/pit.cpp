@@ -1,16 +1,16 @@
 #include <bolgenos-ng/pit.hpp>
 
+#include <algorithm.hpp>
 #include <cstdint.hpp>
-#include <memory.hpp>
 
 #include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/clock_event.hpp>
+#include <bolgenos-ng/error.h>
 #include <bolgenos-ng/interrupt_controller.hpp>
 #include <bolgenos-ng/irq.hpp>
 #include <mem_utils.hpp>
 #include <bolgenos-ng/time.hpp>
 
-#include "frequency_divider.hpp"
-
 #include "config.h"
 
 using namespace lib;
@@ -24,19 +24,51 @@ namespace {
 ///
 /// Frequency of PIT chip 8253/8254. This frequency will be divided
 /// by configured value.
-constexpr unsigned long PIT_FREQUENCY = 1193182;
+constexpr uint32_t PIT_FREQUENCY = 1193182;
 
 
 /// \brief Max divider.
 ///
 /// Maximal number that can be used as frequency divider.
-constexpr unsigned long MAX_DIVIDER = 65535;
+constexpr uint32_t MAX_DIVIDER = 65535;
+
+
+/// \brief Min divider.
+///
+/// Minimal number that is used as one-shot timeout. Shorter timeouts make
+/// no sense since interrupt handling takes longer than that.
+constexpr uint32_t MIN_DIVIDER = 64;
+
+
+/// Shift of \ref PIT_NS_MULT.
+constexpr unsigned PIT_NS_SHIFT = 24;
+
+
+/// PIT cycles per nanosecond multiplied by 2^PIT_NS_SHIFT.
+constexpr uint64_t PIT_NS_MULT = (static_cast<uint64_t>(PIT_FREQUENCY) << PIT_NS_SHIFT)
+	/ time::NSEC_PER_SEC;
+
+
+/// Duration of the longest one-shot in nanoseconds.
+constexpr uint64_t MAX_SHOT_NS = MAX_DIVIDER * time::NSEC_PER_SEC / PIT_FREQUENCY;
 
 
 enum pit_port: uint16_t {
 	timer			= 0x40,
 	speaker			= 0x42,
 	cmd			= 0x43,
+	control			= 0x61,
+};
+
+
+/// \brief Bits of system control port.
+enum control_bits: uint8_t {
+	/// Gate of channel 2.
+	gate2			= 1 << 0,
+	/// Connection of channel 2 to the speaker.
+	speaker_data		= 1 << 1,
+	/// State of OUT pin of channel 2.
+	out2			= 1 << 5,
 };
 
 
@@ -72,38 +104,113 @@ enum pit_channel: uint8_t {
 };
 
 
-class PitIRQHandler: public irq::IRQHandler {
+/// \brief PIT as clock event device.
+///
+/// The class drives channel 0 of PIT either in mode 0 ("interrupt on
+/// terminal count") for one-shot events or in mode 2 ("rate generator") for
+/// periodic ones.
+class PitClockEvent: public devices::ClockEventDevice, public irq::IRQHandler {
 public:
-	PitIRQHandler() = delete;
-	PitIRQHandler(const PitIRQHandler&) = delete;
-	PitIRQHandler(PitIRQHandler&&) = delete;
-	PitIRQHandler& operator =(const PitIRQHandler&) = delete;
-	PitIRQHandler& operator =(PitIRQHandler&&) = delete;
+	PitClockEvent() = default;
+	PitClockEvent(const PitClockEvent&) = delete;
+	PitClockEvent(PitClockEvent&&) = delete;
+	PitClockEvent& operator =(const PitClockEvent&) = delete;
+	PitClockEvent& operator =(PitClockEvent&&) = delete;
+
+	virtual ~PitClockEvent() {}
 
 
-	explicit PitIRQHandler(unique_ptr<pit::details::FrequencyDivider> divider)
-			:_divider(move(divider))
+	const char *name() const override
 	{
+		return "pit";
 	}
 
-	virtual ~PitIRQHandler() {}
 
-	status_t handle_irq(irq::irq_t vector __attribute__((unused))) override
+	int rating() const override
+	{
+		return 50;
+	}
+
+
+	uint32_t features() const override
 	{
-		if (_divider->do_tick()) {
-			if constexpr(VERBOSE_TIMER_INTERRUPT)
-			{
-				LOG_INFO << "jiffy #" << jiffies.load() << lib::endl;
-			}
-			++jiffies;
+		if constexpr(PIT_FREQUENCY / HZ <= MAX_DIVIDER) {
+			return feature_t::oneshot | feature_t::periodic;
+		} else {
+			return feature_t::oneshot;
 		}
+	}
+
+
+	void set_periodic(uint32_t hz) override
+	{
+		program(oper_mode::m2, PIT_FREQUENCY / hz);
+	}
+
+
+	void set_next_event(uint64_t delta_ns) override
+	{
+		if (delta_ns >= MAX_SHOT_NS) {
+			program(oper_mode::m0, MAX_DIVIDER);
+		} else {
+			program(oper_mode::m0,
+				static_cast<uint32_t>((delta_ns * PIT_NS_MULT) >> PIT_NS_SHIFT) + 1);
+		}
+	}
+
+
+	uint64_t max_delta_ns() const override
+	{
+		return MAX_SHOT_NS;
+	}
+
+
+	void shutdown() override
+	{
+		// Counter in mode 0 doesn't start until the count is written.
+		outb(pit_port::cmd, pit_channel::ch0|acc_mode::both|oper_mode::m0|num_mode::bin);
+	}
+
+
+	status_t handle_irq(irq::irq_t vector __attribute__((unused))) override
+	{
+		event();
 		return status_t::HANDLED;
 	}
 
 private:
-	unique_ptr<pit::details::FrequencyDivider> _divider;
+	void program(oper_mode mode, uint32_t count)
+	{
+		count = lib::max(lib::min(count, MAX_DIVIDER), MIN_DIVIDER);
+
+		outb(pit_port::cmd, pit_channel::ch0|acc_mode::both|mode|num_mode::bin);
+		outb(pit_port::timer, shiftmask(count, 0, 0xff));
+		outb(pit_port::timer, shiftmask(count, 8, 0xff));
+	}
 };
 
+
+/// \brief Calibrate TSC.
+///
+/// The function measures number of TSC cycles during
+/// \ref pit::CALIBRATION_MS and initializes TSC-based clock.
+void calibrate_tsc()
+{
+	if (!(x86::cpuid(1).edx & x86::cpuid_feature::edx_tsc)) {
+		panic("CPU has no TSC");
+	}
+
+	const uint64_t start = x86::read_tsc();
+	pit::calibration_wait();
+	const uint64_t end = x86::read_tsc();
+
+	uint64_t khz = end - start;
+	x86::div64(khz, pit::CALIBRATION_MS);
+	time::details::init_tsc(static_cast<uint32_t>(khz), end);
+
+	LOG_NOTICE << "TSC frequency: " << static_cast<uint32_t>(khz) << " kHz" << endl;
+}
+
 } // namespace
 
 
@@ -111,17 +218,29 @@ private:
 void pit::init() {
 	const irq::irq_t timer_irq = devices::InterruptController::instance()->min_irq_vector() + 0;
 
-	auto freq_divider = make_unique<pit::details::FrequencyDivider>();
-	freq_divider->set_frequency(HZ, PIT_FREQUENCY, MAX_DIVIDER);
-	if (freq_divider->is_low_frequency())
-		LOG_WARN << "PIT: losing accuracy of timer" << endl;
+	calibrate_tsc();
 
-	uint8_t cmd = pit_channel::ch0|acc_mode::latch|oper_mode::m2|num_mode::bin;
+	auto pit = new PitClockEvent();
+	irq::InterruptsManager::instance()->add_handler(timer_irq, pit);
+	devices::ClockEventDevice::register_device(pit);
+}
 
-	outb(pit_port::cmd, cmd);
-	outb(pit_port::timer, shiftmask(freq_divider->pit_timeout(), 0, 0xff));
-	outb(pit_port::timer, shiftmask(freq_divider->pit_timeout(), 8, 0xff));
 
-	irq::InterruptsManager::instance()->add_handler(timer_irq, new PitIRQHandler(move(freq_divider)));
-}
+void pit::calibration_wait()
+{
+	constexpr uint32_t count = PIT_FREQUENCY * CALIBRATION_MS / 1000;
+	static_assert(count <= MAX_DIVIDER, "calibration period is too long");
+
+	const uint8_t control = inb(pit_port::control);
+	outb(pit_port::control, static_cast<uint8_t>(
+		(control & ~control_bits::speaker_data) | control_bits::gate2));
+
+	outb(pit_port::cmd, pit_channel::ch2|acc_mode::both|oper_mode::m0|num_mode::bin);
+	outb(pit_port::speaker, shiftmask(count, 0, 0xff));
+	outb(pit_port::speaker, shiftmask(count, 8, 0xff));
 
+	while (!(inb(pit_port::control) & control_bits::out2)) {
+	}
+
+	outb(pit_port::control, control);
+}
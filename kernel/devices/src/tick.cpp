@@ -0,0 +1,201 @@
+#include <bolgenos-ng/tick.hpp>
+
+#include <algorithm.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/clock_event.hpp>
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/lapic.hpp>
+#include <bolgenos-ng/time.hpp>
+#include <threading/threading.hpp>
+#include <x86/percpu.hpp>
+
+#include <logger.hpp>
+
+#include "config.h"
+
+LOCAL_LOGGER("tick", lib::LogLevel::INFO);
+
+
+namespace {
+
+
+/// \brief No deadline.
+///
+/// Value of deadline that means that nobody waits for timer event.
+constexpr uint64_t NO_DEADLINE = ~static_cast<uint64_t>(0);
+
+
+/// Duration of one jiffy in nanoseconds.
+constexpr uint32_t NSEC_PER_JIFFY = time::NSEC_PER_SEC / HZ;
+
+
+/// Selected clock event device.
+devices::ClockEventDevice *device = nullptr;
+
+
+/// Device is running in periodic mode.
+bool periodic = false;
+
+
+/// The nearest requested deadline.
+uint64_t deadline = NO_DEADLINE;
+
+
+/// Lock that protects the deadline and programming of the device.
+thr::IrqSpinLock tick_lock{"tick"};
+
+
+/// \brief Update jiffies.
+///
+/// Jiffies are derived from monotonic clock, so they stay correct regardless
+/// of moments when timer events happen.
+void update_jiffies(uint64_t now)
+{
+	x86::div64(now, NSEC_PER_JIFFY);
+	const uint32_t new_jiffies = static_cast<uint32_t>(now);
+	if (new_jiffies == jiffies.load()) {
+		return;
+	}
+
+	if constexpr(VERBOSE_TIMER_INTERRUPT)
+	{
+		BLOG_INFO("jiffy #%u", new_jiffies);
+	}
+	jiffies.store(new_jiffies);
+}
+
+
+/// \brief Program the next one-shot event.
+///
+/// \param now Current time.
+void program_next_event(uint64_t now)
+{
+	uint64_t target = deadline;
+	if constexpr(!TICKLESS) {
+		const uint64_t next_jiffy = static_cast<uint64_t>(jiffies.load() + 1)
+			* NSEC_PER_JIFFY;
+		target = lib::min(target, next_jiffy);
+	}
+
+	if (target == NO_DEADLINE) {
+		device->set_next_event(device->max_delta_ns());
+	} else {
+		device->set_next_event(target > now ? target - now : 0);
+	}
+}
+
+
+/// \brief Handle timer event.
+///
+/// The function is called from interrupt handler of the selected device.
+/// Timer events are delivered to the boot CPU only, so other CPUs are asked
+/// to look for woken tasks when the deadline passes.
+void handle_event()
+{
+	const uint64_t now = time::now_ns();
+	update_jiffies(now);
+
+	const bool expired = thr::with_lock(tick_lock, [now]() -> bool {
+		const bool expired = now >= deadline;
+		if (expired) {
+			deadline = NO_DEADLINE;
+		}
+		if (!periodic) {
+			program_next_event(now);
+		}
+		return expired;
+	});
+
+	if (expired && x86::online_cpus() > 1) {
+		lapic::send_ipi_all_but_self(lapic::reschedule_vector);
+	}
+}
+
+
+/// \brief Handler of requests of other CPUs.
+///
+/// Other CPUs can't program timer of the boot CPU, so they update the
+/// deadline and ask the boot CPU to reprogram the timer.
+class TickRequestHandler: public irq::IRQHandler {
+public:
+	status_t handle_irq(irq::irq_t vector __attribute__((unused))) override
+	{
+		thr::with_lock(tick_lock, []() {
+			program_next_event(time::now_ns());
+		});
+		return status_t::HANDLED;
+	}
+};
+
+
+} // namespace
+
+
+void tick::init()
+{
+	device = devices::ClockEventDevice::select_best();
+	if (!device) {
+		panic("no clock event devices");
+	}
+
+	device->set_event_handler(handle_event);
+
+	if (!TICKLESS && device->has_feature(devices::ClockEventDevice::periodic)) {
+		periodic = true;
+		device->set_periodic(HZ);
+	} else {
+		program_next_event(time::now_ns());
+	}
+
+	if (SMP) {
+		irq::InterruptsManager::instance()->add_handler(lapic::tick_vector,
+			new TickRequestHandler());
+	}
+}
+
+
+void tick::request_event(uint64_t deadline_ns)
+{
+	// Deadline is kept even in periodic mode: its expiration wakes up
+	// other CPUs.
+	const bool forward = thr::with_lock(tick_lock, [deadline_ns]() -> bool {
+		if (deadline_ns >= deadline) {
+			return false;
+		}
+		deadline = deadline_ns;
+		if (periodic) {
+			// Timer fires every jiffy anyway.
+			return false;
+		}
+		if (x86::this_cpu()->index != 0) {
+			return true;
+		}
+		program_next_event(time::now_ns());
+		return false;
+	});
+
+	if (forward) {
+		lapic::send_ipi(x86::cpu_by_index(0)->apic_id,
+			lapic::icr_fixed | lapic::tick_vector);
+	}
+}
+
+
+void tick::idle()
+{
+	if (!irq::is_enabled()) {
+		panic("going to idle with disabled interrupts");
+	}
+
+	// Wake-up request may come between the check and halt, so
+	// interrupts are enabled by `sti` that takes effect after the next
+	// instruction.
+	irq::disable(false);
+	if (x86::this_cpu()->need_resched.exchange(false)) {
+		irq::enable(false);
+		return;
+	}
+	x86::enable_and_halt_cpu();
+}
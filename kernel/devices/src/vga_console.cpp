@@ -3,11 +3,16 @@
 #include <algorithm.hpp>
 #include <cstdint.hpp>
 
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/fb_console.hpp>
+
 namespace {
 
 
 struct __attribute__((packed)) cell_t {
-	cell_t(char ch, vga_console::color_t fg, vga_console::color_t bg)
+	constexpr cell_t()
+		: cell_t(' ', vga_console::color_t::grey, vga_console::color_t::black) {}
+	constexpr cell_t(char ch, vga_console::color_t fg, vga_console::color_t bg)
 		: ch_(ch), fg_(fg), bg_(bg) {}
 	char ch_:8;
 	uint8_t fg_:4;
@@ -23,10 +28,54 @@ vga_console::color_t global_bg = vga_console::color_t::black;
 vga_console::color_t global_fg = vga_console::color_t::grey;
 
 
-int screen_height = 25, screen_width = 80;
+constexpr int screen_height = 25, screen_width = 80;
 int cursor_line = 0, cursor_column = 0;
 
 
+/// Text mode video memory is 32 KiB, i.e. enough for 204 lines.
+constexpr int video_memory_lines = 0x8000 / sizeof(cell_t) / screen_width;
+
+
+/// \brief Copy of the screen in RAM.
+///
+/// Lines are kept in a ring: logical line 0 is `shadow[shadow_top]`, so
+/// scrolling doesn't move any cells.
+cell_t shadow[screen_height][screen_width];
+int shadow_top = 0;
+
+
+/// Bit N is set if logical line N differs from video memory.
+uint32_t dirty_lines = 0;
+constexpr uint32_t all_lines = (1u << screen_height) - 1;
+static_assert(screen_height <= 32, "dirty_lines is too small");
+
+
+/// Line of video memory shown at the top of the screen.
+int start_line = 0;
+
+/// Number of scrolls since the last flush.
+int pending_scroll = 0;
+
+/// Start address that is programmed into CRTC, -1 if it's unknown.
+int programmed_start = -1;
+
+
+/// CRT controller ports of color text mode.
+enum crtc_port: uint16_t {
+	crtc_index		= 0x3d4,
+	crtc_data		= 0x3d5,
+};
+
+
+/// CRT controller registers.
+enum crtc_register: uint8_t {
+	crtc_start_address_high	= 0x0c,
+	crtc_start_address_low	= 0x0d,
+	crtc_cursor_high	= 0x0e,
+	crtc_cursor_low		= 0x0f,
+};
+
+
 const char LF = '\n';
 const char CR = '\r';
 
@@ -39,6 +88,8 @@ void carriage_return();
 
 
 cell_t *cursor_address();
+cell_t *shadow_line(int line);
+void write_crtc_address(crtc_register high, uint16_t address);
 
 
 } // namespace
@@ -68,6 +119,10 @@ vga_console::color_t vga_console::get_fg() {
 
 
 void vga_console::putc_color(char symbol, color_t fg, color_t bg) {
+	if (fb_console::is_active()) {
+		fb_console::putc_color(symbol, fg, bg);
+		return;
+	}
 	switch (symbol) {
 	case LF:
 		line_break();
@@ -79,6 +134,7 @@ void vga_console::putc_color(char symbol, color_t fg, color_t bg) {
 		{
 			cell_t cell = cell_t(symbol, fg, bg);
 			*cursor_address() = cell;
+			dirty_lines |= 1u << cursor_line;
 			cursor_next();
 		}
 	}
@@ -101,12 +157,53 @@ void vga_console::puts_color(const char* string, color_t fg,
 		vga_console::putc_color(*string, fg, bg);
 		++string;
 	}
+	flush();
 }
 
 
 void vga_console::clear_screen() {
+	if (fb_console::is_active()) {
+		fb_console::clear(global_fg, global_bg);
+		return;
+	}
 	cell_t empty = cell_t(' ', global_fg, global_bg);
-	lib::fill_n(iomem, screen_height*screen_width, empty);
+	lib::fill_n(&shadow[0][0], screen_height*screen_width, empty);
+	dirty_lines = all_lines;
+	flush();
+}
+
+
+void vga_console::flush() {
+	if (fb_console::is_active()) {
+		fb_console::flush();
+		return;
+	}
+	if (pending_scroll) {
+		start_line += pending_scroll;
+		pending_scroll = 0;
+		if (start_line + screen_height > video_memory_lines) {
+			// The end of video memory is reached: the screen is
+			// redrawn from the beginning of video memory.
+			start_line = 0;
+			dirty_lines = all_lines;
+		}
+	}
+
+	for (int line = 0; dirty_lines; ++line) {
+		if (dirty_lines & (1u << line)) {
+			lib::copy_n(shadow_line(line), screen_width,
+				iomem + (start_line + line) * screen_width);
+			dirty_lines &= ~(1u << line);
+		}
+	}
+
+	const int start = start_line * screen_width;
+	if (start != programmed_start) {
+		write_crtc_address(crtc_start_address_high, start);
+		programmed_start = start;
+	}
+	write_crtc_address(crtc_cursor_high,
+		start + cursor_line * screen_width + cursor_column);
 }
 
 
@@ -144,16 +241,17 @@ void line_break() {
 
 
 /**
-* Scrool vga display on one line.
+* Scroll vga display on one line.
+*
+* Only the shadow ring is rotated here; video memory is scrolled on flush by
+*	moving CRTC start address.
 */
 void scroll() {
-	for (int i = 0; i < screen_height - 1; ++i) {
-		lib::copy_n(iomem + (i+1) * screen_width, screen_width,
-			iomem + i * screen_width);
-	}
+	shadow_top = (shadow_top + 1) % screen_height;
 	cell_t empty = cell_t(' ', global_fg, global_bg);
-	lib::fill_n(iomem + (screen_height - 1) * screen_width, screen_width,
-		empty);
+	lib::fill_n(shadow_line(screen_height - 1), screen_width, empty);
+	dirty_lines = (dirty_lines >> 1) | (1u << (screen_height - 1));
+	++pending_scroll;
 }
 
 
@@ -169,7 +267,26 @@ void carriage_return() {
 * Get pointer to cursor cell.
 */
 cell_t *cursor_address() {
-	return iomem + cursor_line*screen_width + cursor_column;
+	return shadow_line(cursor_line) + cursor_column;
+}
+
+
+/**
+* Get pointer to the first cell of logical line in the shadow buffer.
+*/
+cell_t *shadow_line(int line) {
+	return shadow[(shadow_top + line) % screen_height];
+}
+
+
+/**
+* Write 16-bit address to the pair of CRTC registers.
+*/
+void write_crtc_address(crtc_register high, uint16_t address) {
+	outb(crtc_port::crtc_index, high);
+	outb(crtc_port::crtc_data, static_cast<uint8_t>(address >> 8));
+	outb(crtc_port::crtc_index, static_cast<uint8_t>(high + 1));
+	outb(crtc_port::crtc_data, static_cast<uint8_t>(address));
 }
 
 
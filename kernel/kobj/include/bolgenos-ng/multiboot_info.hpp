@@ -10,6 +10,31 @@
 namespace multiboot {
 
 
+/// \brief Framebuffer provided by bootloader.
+struct __attribute__((packed)) framebuffer_t {
+	uint64_t address;	///< Physical address of framebuffer.
+	uint32_t pitch;		///< Number of bytes in one line.
+	uint32_t width;		///< Width in pixels.
+	uint32_t height;	///< Height in pixels.
+	uint8_t bpp;		///< Bits per pixel.
+	uint8_t type;		///< 0: indexed, 1: direct RGB, 2: EGA text.
+	uint8_t red_position;
+	uint8_t red_size;
+	uint8_t green_position;
+	uint8_t green_size;
+	uint8_t blue_position;
+	uint8_t blue_size;
+};
+
+
+/// Value of \ref framebuffer_t::type for direct RGB color.
+constexpr uint8_t FRAMEBUFFER_RGB = 1;
+
+
+/// Value of \ref framebuffer_t::type for VGA text mode.
+constexpr uint8_t FRAMEBUFFER_EGA_TEXT = 2;
+
+
 /// \brief Boot information.
 ///
 /// More info about members can be read in the following article:
@@ -40,6 +65,13 @@ public:
 	/// \return Size of high memory.
 	uint32_t high_memory() const;
 
+
+	/// \brief Get framebuffer.
+	///
+	/// \return Framebuffer set up by bootloader or nullptr if bootloader
+	///	didn't provide framebuffer information.
+	const framebuffer_t* framebuffer() const;
+
 protected:
 	uint32_t flags_;	///< Multiboot information status.
 	uint32_t mem_lower_;	///< Amount of low memory in kilobytes.
@@ -68,6 +100,7 @@ protected:
 	uint16_t vbe_interface_seg;
 	uint16_t vbe_interface_off;
 	uint16_t vbe_interface_len;
+	framebuffer_t framebuffer_;
 };
 
 
@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 
+#include "config.h"
+
 struct _packed_ multiboot_hdr {
 	uint32_t magic;
 	uint32_t flags;
@@ -26,20 +28,42 @@ struct _packed_ multiboot_hdr {
 enum mboot_flags {
 	mbf_align			= 1 << 0,
 	mbf_meminfo			= 1 << 1,
+	mbf_video			= 1 << 2,
 };
 
+/// Linear graphics mode in mode_type field.
+#define mboot_linear_mode		(0)
+
 #define		mboot_header_initializer(_flags) {			\
 	.magic		= mboot_magic,					\
 	.flags		= (_flags),					\
 	.checksum	= mboot_checksum((_flags))			\
 }
 
+#define		mboot_video_header_initializer(_flags) {		\
+	.magic		= mboot_magic,					\
+	.flags		= (_flags),					\
+	.checksum	= mboot_checksum((_flags)),			\
+	.mode_type	= mboot_linear_mode,				\
+	.width		= FRAMEBUFFER_WIDTH,				\
+	.height		= FRAMEBUFFER_HEIGHT,				\
+	.depth		= 32						\
+}
+
 /**
 * \brief Multiboot header.
 *
 * This symbols declares multiboot header for kernel. It must be placed into
 *	separate section and this section must be placed by linker to the
-*	beginning of resulting ELF-file.
+*	beginning of resulting ELF-file. If framebuffer console is enabled,
+*	the header asks bootloader for linear framebuffer; bootloader may
+*	ignore the request and leave text mode, or set up another mode.
 */
+#if FRAMEBUFFER_CONSOLE
+struct multiboot_hdr __multiboot_section__ _used_
+	multiboot_header = mboot_video_header_initializer(
+		mbf_align | mbf_meminfo | mbf_video);
+#else
 struct multiboot_hdr __multiboot_section__ _used_
 	multiboot_header = mboot_header_initializer(mbf_align | mbf_meminfo);
+#endif
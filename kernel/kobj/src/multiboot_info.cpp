@@ -1,6 +1,6 @@
 #include <bolgenos-ng/multiboot_info.hpp>
 
-static_assert(sizeof(multiboot::boot_info_t) == 88,
+static_assert(sizeof(multiboot::boot_info_t) == 116,
 	"Multiboot Information header has wrong size");
 
 
@@ -13,6 +13,8 @@ namespace {
 enum info_flag_t:uint32_t {
 	/// If this flag is set values mem_lower and mem_upper are valid.
 	mem_info			= (1 << 0),
+	/// If this flag is set framebuffer information is valid.
+	framebuffer_info		= (1 << 12),
 };
 
 
@@ -58,3 +60,8 @@ uint32_t multiboot::boot_info_t::low_memory() const {
 uint32_t multiboot::boot_info_t::high_memory() const {
 	return mem_upper_;
 }
+
+
+const multiboot::framebuffer_t* multiboot::boot_info_t::framebuffer() const {
+	return (flags_ & info_flag_t::framebuffer_info) ? &framebuffer_ : nullptr;
+}
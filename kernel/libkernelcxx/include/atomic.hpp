@@ -1,124 +1,422 @@
 #pragma once
 
-#include <bolgenos-ng/asm.hpp>
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+#include <type_traits.hpp>
 
 
 namespace lib {
 
 
-template<class T>
-struct atomic
+/// \brief Memory ordering constraints.
+///
+/// Values have the same meaning as in the standard library. On x86 loads
+/// have acquire and stores have release semantics anyway, so all orders but
+/// seq_cst store are compiled to plain moves and differ only in compiler
+/// reordering.
+enum class memory_order: int {
+	relaxed = __ATOMIC_RELAXED,
+	consume = __ATOMIC_CONSUME,
+	acquire = __ATOMIC_ACQUIRE,
+	release = __ATOMIC_RELEASE,
+	acq_rel = __ATOMIC_ACQ_REL,
+	seq_cst = __ATOMIC_SEQ_CST,
+};
+
+inline constexpr memory_order memory_order_relaxed = memory_order::relaxed;
+inline constexpr memory_order memory_order_consume = memory_order::consume;
+inline constexpr memory_order memory_order_acquire = memory_order::acquire;
+inline constexpr memory_order memory_order_release = memory_order::release;
+inline constexpr memory_order memory_order_acq_rel = memory_order::acq_rel;
+inline constexpr memory_order memory_order_seq_cst = memory_order::seq_cst;
+
+
+namespace details {
+
+
+constexpr int to_builtin(memory_order order)
 {
-public:
-	atomic() = default;
+	return static_cast<int>(order);
+}
+
+
+/// \brief Order of failed compare-and-exchange.
+///
+/// Failed compare-and-exchange is a load, so it can't have release
+/// semantics.
+constexpr int failure_order(memory_order order)
+{
+	switch (order) {
+	case memory_order::acq_rel:
+		return __ATOMIC_ACQUIRE;
+	case memory_order::release:
+		return __ATOMIC_RELAXED;
+	default:
+		return to_builtin(order);
+	}
+}
+
+
+/// \brief Block current task while value at address is equal to old one.
+///
+/// The function is implemented by the scheduler. Waiting tasks may be woken
+/// up spuriously, so callers must check the value again.
+///
+/// \param addr Address of the value.
+/// \param size Size of the value; up to 4 bytes are supported.
+/// \param old Bitwise representation of the old value.
+void atomic_wait(const volatile void* addr, size_t size, uint32_t old);
+
+
+/// \brief Wake up tasks that wait for value at address.
+///
+/// \param addr Address of the value.
+/// \param all Wake up all tasks rather than one.
+void atomic_notify(const volatile void* addr, bool all);
+
+
+template<typename T>
+inline uint32_t to_word(const T& value)
+{
+	static_assert(sizeof(T) <= sizeof(uint32_t),
+		"only values up to 4 bytes can be waited for");
+	uint32_t word = 0;
+	__builtin_memcpy(&word, &value, sizeof(T));
+	return word;
+}
+
 
+/// Operations common for all atomic types.
+template<typename T>
+class atomic_base
+{
+public:
+	atomic_base() = default;
 
-	inline
-	constexpr atomic(T value) :
+	constexpr atomic_base(T value) :
 		_value(value)
 	{
 	}
 
-	atomic(const atomic& other) = delete;
+	atomic_base(const atomic_base&) = delete;
+	atomic_base& operator=(const atomic_base&) = delete;
+
 
+	static constexpr bool is_always_lock_free = sizeof(T) <= sizeof(uint32_t);
 
-	inline
-	T load() const
+
+	T load(memory_order order = memory_order::seq_cst) const
 	{
-		T local;
-		x86::load<T>(_value, local);
-		return local;
+		return __atomic_load_n(&_value, to_builtin(order));
 	}
 
 
-	inline
 	explicit operator T() const
 	{
 		return load();
 	}
 
 
-	inline
-	void store(T value)
+	void store(T value, memory_order order = memory_order::seq_cst)
+	{
+		__atomic_store_n(&_value, value, to_builtin(order));
+	}
+
+
+	T exchange(T value, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_exchange_n(&_value, value, to_builtin(order));
+	}
+
+
+	/// \brief Compare and exchange.
+	///
+	/// On failure \p expected is updated with the observed value.
+	bool compare_exchange_strong(T& expected, T desired,
+		memory_order order = memory_order::seq_cst)
 	{
-		x86::store<T>(value, _value);
+		return __atomic_compare_exchange_n(&_value, &expected, desired,
+			false, to_builtin(order), failure_order(order));
 	}
 
 
-	inline
-	T exchange(T value)
+	/// \brief Compare and exchange that may fail spuriously.
+	///
+	/// x86 has no spurious failures, so the function is the same as
+	/// \ref compare_exchange_strong.
+	bool compare_exchange_weak(T& expected, T desired,
+		memory_order order = memory_order::seq_cst)
 	{
-		x86::exchange<T>(_value, value);
-		return value;
+		return __atomic_compare_exchange_n(&_value, &expected, desired,
+			true, to_builtin(order), failure_order(order));
 	}
 
 
-	inline
+	/// \brief Compare and exchange without reporting observed value.
+	///
+	/// \return true if the value was equal to \p expected and was replaced.
 	bool compare_exchange(T expected, T desired)
 	{
-		return __sync_bool_compare_and_swap(&_value, expected, desired);
+		return compare_exchange_strong(expected, desired);
 	}
 
 
-	inline
-	T fetch_add(T increment)
+	/// \brief Wait for change of the value.
+	///
+	/// The function blocks current task while the value is equal to
+	/// \p old. The function must not be called by interrupt handlers.
+	void wait(T old, memory_order order = memory_order::seq_cst) const
 	{
-		return x86::fetch_add<T>(_value, increment);
+		const uint32_t old_word = to_word(old);
+		while (to_word(load(order)) == old_word) {
+			atomic_wait(&_value, sizeof(T), old_word);
+		}
 	}
 
 
-	inline
-	T fetch_sub(T decrement)
+	/// Wake up one task that waits for change of the value.
+	void notify_one()
 	{
-		return fetch_add(-decrement);
+		atomic_notify(&_value, false);
 	}
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Weffc++"
-	inline
-	T operator++()
+
+	/// Wake up all tasks that wait for change of the value.
+	void notify_all()
 	{
-#pragma GCC diagnostic pop
+		atomic_notify(&_value, true);
+	}
+
+protected:
+	T _value{};
+};
 
-		T value = fetch_add(1);
-		++value;
-		return value;
+
+} // namespace details
+
+
+/// \brief Atomic value.
+///
+/// Arithmetic and bit operations are available for integral types.
+template<class T>
+struct atomic: public details::atomic_base<T>
+{
+public:
+	using details::atomic_base<T>::atomic_base;
+	using details::atomic_base<T>::_value;
+
+
+	T fetch_add(T increment, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_add(&_value, increment,
+			details::to_builtin(order));
+	}
+
+
+	T fetch_sub(T decrement, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_sub(&_value, decrement,
+			details::to_builtin(order));
+	}
+
+
+	T fetch_and(T mask, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_and(&_value, mask,
+			details::to_builtin(order));
+	}
+
+
+	T fetch_or(T mask, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_or(&_value, mask,
+			details::to_builtin(order));
+	}
+
+
+	T fetch_xor(T mask, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_xor(&_value, mask,
+			details::to_builtin(order));
 	}
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Weffc++"
-	inline
+	T operator++()
+	{
+		return fetch_add(1) + 1;
+	}
+
 	T operator++(int)
 	{
-#pragma GCC diagnostic pop
-		T tmp = fetch_add(1);
-		return tmp;
+		return fetch_add(1);
 	}
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Weffc++"
-	inline
 	T operator--()
 	{
+		return fetch_sub(1) - 1;
+	}
+
+	T operator--(int)
+	{
+		return fetch_sub(1);
+	}
 #pragma GCC diagnostic pop
-		T value = fetch_sub(1);
-		--value;
-		return value;
+
+	T operator+=(T increment)
+	{
+		return fetch_add(increment) + increment;
+	}
+
+	T operator-=(T decrement)
+	{
+		return fetch_sub(decrement) - decrement;
+	}
+
+	T operator&=(T mask)
+	{
+		return fetch_and(mask) & mask;
+	}
+
+	T operator|=(T mask)
+	{
+		return fetch_or(mask) | mask;
+	}
+
+	T operator^=(T mask)
+	{
+		return fetch_xor(mask) ^ mask;
+	}
+};
+
+
+/// \brief Atomic pointer.
+///
+/// Arithmetic is scaled by size of pointed type like for plain pointers.
+template<class T>
+struct atomic<T*>: public details::atomic_base<T*>
+{
+public:
+	using details::atomic_base<T*>::atomic_base;
+	using details::atomic_base<T*>::_value;
+
+
+	T* fetch_add(ptrdiff_t increment, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_add(&_value,
+			increment * static_cast<ptrdiff_t>(sizeof(T)),
+			details::to_builtin(order));
+	}
+
+
+	T* fetch_sub(ptrdiff_t decrement, memory_order order = memory_order::seq_cst)
+	{
+		return __atomic_fetch_sub(&_value,
+			decrement * static_cast<ptrdiff_t>(sizeof(T)),
+			details::to_builtin(order));
 	}
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Weffc++"
-	inline
-	T operator--(int)
+	T* operator++()
+	{
+		return fetch_add(1) + 1;
+	}
+
+	T* operator++(int)
 	{
+		return fetch_add(1);
+	}
+
+	T* operator--()
+	{
+		return fetch_sub(1) - 1;
+	}
+
+	T* operator--(int)
+	{
+		return fetch_sub(1);
+	}
 #pragma GCC diagnostic pop
-		T tmp = fetch_sub(1);
-		return tmp;
+
+	T* operator+=(ptrdiff_t increment)
+	{
+		return fetch_add(increment) + increment;
+	}
+
+	T* operator-=(ptrdiff_t decrement)
+	{
+		return fetch_sub(decrement) - decrement;
+	}
+};
+
+
+/// \brief Atomic boolean flag.
+class atomic_flag
+{
+public:
+	atomic_flag() = default;
+
+	atomic_flag(const atomic_flag&) = delete;
+	atomic_flag& operator=(const atomic_flag&) = delete;
+
+
+	/// \brief Set the flag.
+	///
+	/// \return Previous state of the flag.
+	bool test_and_set(memory_order order = memory_order::seq_cst)
+	{
+		return _flag.exchange(true, order);
+	}
+
+
+	void clear(memory_order order = memory_order::seq_cst)
+	{
+		_flag.store(false, order);
+	}
+
+
+	[[nodiscard]]
+	bool test(memory_order order = memory_order::seq_cst) const
+	{
+		return _flag.load(order);
+	}
+
+
+	void wait(bool old, memory_order order = memory_order::seq_cst) const
+	{
+		_flag.wait(old, order);
+	}
+
+
+	void notify_one()
+	{
+		_flag.notify_one();
+	}
+
+
+	void notify_all()
+	{
+		_flag.notify_all();
 	}
 
 private:
-	T _value{0};
+	atomic<bool> _flag{false};
 };
 
 
+/// Memory fence.
+inline void atomic_thread_fence(memory_order order)
+{
+	__atomic_thread_fence(details::to_builtin(order));
+}
+
+
+/// Compiler-only fence; orders memory accesses against interrupt handlers.
+inline void atomic_signal_fence(memory_order order)
+{
+	__atomic_signal_fence(details::to_builtin(order));
+}
+
+
 } // namespace lib
@@ -17,6 +17,14 @@ void panic(const char *msg = nullptr);
 [[noreturn]]
 void bug(const char *msg);
 
+/**
+* \brief Add function that is called by panic before the message is printed.
+*
+* Functions are used for flushing buffered output. They are called once with
+*	disabled interrupts in the order they were added.
+*/
+void add_panic_notifier(void (*notifier)());
+
 [[noreturn]]
 void raise_not_implemented(const char* msg = nullptr);
 
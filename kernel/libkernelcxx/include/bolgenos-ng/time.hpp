@@ -29,3 +29,85 @@ void sleep_ms(uint32_t ms);
 */
 uint32_t ms_to_ticks(uint32_t ms);
 
+
+namespace time {
+
+
+/// Number of nanoseconds in one microsecond.
+constexpr uint64_t NSEC_PER_USEC = 1000;
+
+/// Number of nanoseconds in one millisecond.
+constexpr uint64_t NSEC_PER_MSEC = 1000 * NSEC_PER_USEC;
+
+/// Number of nanoseconds in one second.
+constexpr uint64_t NSEC_PER_SEC = 1000 * NSEC_PER_MSEC;
+
+
+/**
+* \brief Monotonic clock.
+*
+* The function returns number of nanoseconds since calibration of the clock
+* at boot. The clock is based on TSC and returns 0 until calibration.
+*
+* \return Nanoseconds since boot.
+*/
+uint64_t now_ns();
+
+
+/// Monotonic clock in microseconds. See \ref now_ns.
+uint64_t now_us();
+
+
+/// Monotonic clock in milliseconds. See \ref now_ns.
+uint64_t now_ms();
+
+
+/**
+* \brief Raw clock cycles.
+*
+* The function returns current value of TSC. It is the cheapest way to measure
+* intervals; use \ref cycles_to_ns to convert result to nanoseconds.
+*/
+uint64_t cycles();
+
+
+/// Convert TSC cycles to nanoseconds.
+uint64_t cycles_to_ns(uint64_t cycles);
+
+
+/// Convert nanoseconds to TSC cycles.
+uint64_t ns_to_cycles(uint64_t ns);
+
+
+/// Frequency of TSC in kHz or 0 if TSC isn't calibrated yet.
+uint32_t tsc_khz();
+
+
+/**
+* \brief Do nothing during specified time.
+*
+* \param ns Timeout in nanoseconds.
+*/
+void sleep_ns(uint64_t ns);
+
+
+/// Do nothing during specified time in microseconds. See \ref sleep_ns.
+void sleep_us(uint64_t us);
+
+
+/// Internal functions of time subsystem.
+namespace details {
+
+
+/**
+* \brief Initialize TSC-based clock.
+*
+* \param khz Calibrated frequency of TSC in kHz.
+* \param reference TSC value that corresponds to zero of monotonic clock.
+*/
+void init_tsc(uint32_t khz, uint64_t reference);
+
+
+} // namespace details
+
+} // namespace time
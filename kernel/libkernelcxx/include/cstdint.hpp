@@ -13,8 +13,10 @@ namespace lib {
 using lib::int8_t;
 using lib::int16_t;
 using lib::int32_t;
+using lib::int64_t;
 
 
 using lib::uint8_t;
 using lib::uint16_t;
 using lib::uint32_t;
+using lib::uint64_t;
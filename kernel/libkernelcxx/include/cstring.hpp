@@ -21,6 +21,18 @@ extern "C" {
 size_t strlen(const char *str);
 
 
+/**
+* \brief POSIX-like strcmp.
+*
+* Compare strings lexicographically.
+* \param s1 Pointer to the first string.
+* \param s2 Pointer to the second string.
+* \return Negative value, zero or positive value if the first string is
+*	less than, equal to or greater than the second one.
+*/
+int strcmp(const char *s1, const char *s2);
+
+
 /**
 * \brief POSIX-like strcpy.
 *
@@ -45,6 +57,44 @@ char *strncpy(char *dest, const char *src, size_t n);
 
 void *memset(void *s, int c, size_t n);
 
+
+/**
+* \brief POSIX-like memcpy.
+*
+* Copy n bytes from source to destination. Memory areas must not overlap.
+* \param dest Pointer to destination.
+* \param src Pointer to source.
+* \param n Number of bytes to copy.
+* \return Pointer to destination.
+*/
+void *memcpy(void *dest, const void *src, size_t n);
+
+
+/**
+* \brief POSIX-like memmove.
+*
+* Copy n bytes from source to destination. Memory areas may overlap. The
+*	bulk of data is copied by 32-bit words using `rep movsl`.
+* \param dest Pointer to destination.
+* \param src Pointer to source.
+* \param n Number of bytes to copy.
+* \return Pointer to destination.
+*/
+void *memmove(void *dest, const void *src, size_t n);
+
+
+/**
+* \brief POSIX-like memcmp.
+*
+* Compare first n bytes of two memory areas.
+* \param s1 Pointer to the first area.
+* \param s2 Pointer to the second area.
+* \param n Number of bytes to compare.
+* \return Zero if areas are equal, negative or positive value if the first
+*	differing byte of s1 is less or greater than the one of s2.
+*/
+int memcmp(const void *s1, const void *s2, size_t n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef.hpp>
 #include <ostream.hpp>
 
 
@@ -19,4 +20,27 @@ void show_backtrace(lib::ostream& out, void *ebp = nullptr,
 		void *eip = nullptr);
 
 
+/// \brief Capture backtrace.
+///
+/// The function saves return addresses of callers starting from specified
+/// base pointer, so that backtrace may be printed later by
+/// \ref show_backtrace. Unlike printing, capturing is cheap enough for code
+/// with disabled interrupts.
+///
+/// \param addresses Array for return addresses.
+/// \param max_depth Size of the array.
+/// \param ebp Base pointer for backtracing; caller's one if not specified.
+/// \return Number of saved addresses.
+size_t capture_backtrace(void **addresses, size_t max_depth,
+		void *ebp = nullptr);
+
+
+/// \brief Show captured backtrace.
+///
+/// \param out Stream for printing backtrace.
+/// \param addresses Return addresses saved by \ref capture_backtrace.
+/// \param depth Number of saved addresses.
+void show_backtrace(lib::ostream& out, void * const *addresses, size_t depth);
+
+
 } // namespace execinfo
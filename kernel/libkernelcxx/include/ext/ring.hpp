@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic.hpp>
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+
+namespace lib {
+
+
+/// Size of CPU cache line in bytes.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+
+namespace details {
+
+
+/// \brief Index that occupies whole cache line.
+///
+/// Producer and consumer indexes are kept in separate cache lines, so that
+/// updates of one of them don't invalidate the other one.
+struct PaddedIndex {
+	lib::atomic<uint32_t> value{0};
+	char padding[CACHE_LINE_SIZE - sizeof(lib::atomic<uint32_t>)]{};
+};
+
+
+} // namespace details
+
+
+/// \brief Single-producer single-consumer ring buffer.
+///
+/// Fixed-capacity queue that needs neither locks nor allocations. Both
+/// sides are wait-free, so the producer may be an interrupt handler and the
+/// consumer a task, or vice versa. Only one producer and one consumer may
+/// use the ring at a time.
+///
+/// \tparam T Type of elements.
+/// \tparam N Capacity of the ring; must be a power of two.
+template<typename T, size_t N>
+class SpscRing {
+	static_assert(N != 0 && (N & (N - 1)) == 0,
+		"capacity of ring must be a power of two");
+public:
+	SpscRing() = default;
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+
+	/// \brief Put element to the ring.
+	///
+	/// \return false if the ring is full.
+	bool try_push(const T& value) {
+		const uint32_t head = _head.value.load();
+		if (head - _tail.value.load() == N) {
+			return false;
+		}
+		_data[head & MASK] = value;
+		_head.value.store(head + 1);
+		return true;
+	}
+
+
+	/// \brief Take element from the ring.
+	///
+	/// \return false if the ring is empty.
+	bool try_pop(T& value) {
+		const uint32_t tail = _tail.value.load();
+		if (tail == _head.value.load()) {
+			return false;
+		}
+		value = _data[tail & MASK];
+		_tail.value.store(tail + 1);
+		return true;
+	}
+
+
+	/// Number of elements in the ring.
+	[[nodiscard]]
+	size_t size() const {
+		return _head.value.load() - _tail.value.load();
+	}
+
+
+	[[nodiscard]]
+	bool empty() const {
+		return size() == 0;
+	}
+
+
+	[[nodiscard]]
+	static constexpr size_t capacity() {
+		return N;
+	}
+
+private:
+	static constexpr uint32_t MASK = N - 1;
+
+	/// Index of the next element to be written; changed by producer.
+	details::PaddedIndex _head{};
+
+	/// Index of the next element to be read; changed by consumer.
+	details::PaddedIndex _tail{};
+
+	T _data[N]{};
+};
+
+
+/// \brief Multiple-producer single-consumer ring buffer.
+///
+/// Fixed-capacity queue that needs neither locks nor allocations. Each
+/// slot has sequence number that tells producers and the consumer whether
+/// the slot is free or filled. Producers reserve slots by compare-and-swap,
+/// so a producer retries only if another producer reserved the same slot
+/// first; the consumer side is wait-free.
+///
+/// \tparam T Type of elements.
+/// \tparam N Capacity of the ring; must be a power of two.
+template<typename T, size_t N>
+class MpscRing {
+	static_assert(N != 0 && (N & (N - 1)) == 0,
+		"capacity of ring must be a power of two");
+public:
+	MpscRing() {
+		for (uint32_t index = 0; index != N; ++index) {
+			_slots[index].sequence.store(index);
+		}
+	}
+
+	MpscRing(const MpscRing&) = delete;
+	MpscRing& operator=(const MpscRing&) = delete;
+
+
+	/// \brief Put element to the ring.
+	///
+	/// \return false if the ring is full.
+	bool try_push(const T& value) {
+		uint32_t head = _head.value.load();
+		Slot* slot;
+		while (true) {
+			slot = &_slots[head & MASK];
+			const auto diff = static_cast<int32_t>(
+				slot->sequence.load() - head);
+			if (diff < 0) {
+				return false;
+			}
+			if (diff == 0 && _head.value.compare_exchange(head, head + 1)) {
+				break;
+			}
+			head = _head.value.load();
+		}
+
+		slot->value = value;
+		slot->sequence.store(head + 1);
+		return true;
+	}
+
+
+	/// \brief Take element from the ring.
+	///
+	/// \return false if the ring is empty or the oldest element is still
+	///	being written.
+	bool try_pop(T& value) {
+		const uint32_t tail = _tail.value.load();
+		Slot& slot = _slots[tail & MASK];
+		if (slot.sequence.load() != tail + 1) {
+			return false;
+		}
+		value = slot.value;
+		slot.sequence.store(tail + N);
+		_tail.value.store(tail + 1);
+		return true;
+	}
+
+
+	/// Approximate number of elements in the ring.
+	[[nodiscard]]
+	size_t size() const {
+		return _head.value.load() - _tail.value.load();
+	}
+
+
+	[[nodiscard]]
+	bool empty() const {
+		return size() == 0;
+	}
+
+
+	[[nodiscard]]
+	static constexpr size_t capacity() {
+		return N;
+	}
+
+private:
+	static constexpr uint32_t MASK = N - 1;
+
+	struct Slot {
+		/// Equals to index for free slot and to index + 1 for filled one.
+		lib::atomic<uint32_t> sequence{0};
+		T value{};
+	};
+
+	/// Index of the next slot to be reserved by producers.
+	details::PaddedIndex _head{};
+
+	/// Index of the next slot to be read by consumer.
+	details::PaddedIndex _tail{};
+
+	Slot _slots[N]{};
+};
+
+
+} // namespace lib
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+#include <ostream.hpp>
+#include <type_traits.hpp>
+
+namespace lib {
+
+
+class streambuf;
+
+
+/// Maximal field width in format specification.
+constexpr size_t MAX_FORMAT_WIDTH = 64;
+
+
+/// Implementation details.
+namespace _impl {
+
+
+/// Kind of formatted argument.
+enum class FormatArgType: uint8_t {
+	CHAR,
+	BOOL,
+	SIGNED,
+	UNSIGNED,
+	STRING,
+	POINTER,
+	/// Any type that can be printed to \ref lib::ostream.
+	CUSTOM,
+};
+
+
+template<class T>
+constexpr FormatArgType format_arg_type()
+{
+	using type = remove_cv_t<T>;
+	if constexpr (is_same<type, char>::value) {
+		return FormatArgType::CHAR;
+	} else if constexpr (is_same<type, bool>::value) {
+		return FormatArgType::BOOL;
+	} else if constexpr (is_signed<type>::value) {
+		static_assert(sizeof(type) <= sizeof(int32_t),
+			"64-bit integers aren't supported");
+		return FormatArgType::SIGNED;
+	} else if constexpr (is_unsigned<type>::value) {
+		static_assert(sizeof(type) <= sizeof(uint32_t),
+			"64-bit integers aren't supported");
+		return FormatArgType::UNSIGNED;
+	} else if constexpr (is_same<type, char*>::value
+			|| is_same<type, const char*>::value
+			|| is_same<remove_extent_t<type>, char>::value
+			|| is_same<remove_extent_t<type>, const char>::value) {
+		return FormatArgType::STRING;
+	} else if constexpr (is_pointer_v<type>) {
+		return FormatArgType::POINTER;
+	} else {
+		return FormatArgType::CUSTOM;
+	}
+}
+
+
+/// Alignment of formatted field.
+enum class FormatAlign: uint8_t {
+	DEFAULT,
+	LEFT,
+	RIGHT,
+	CENTER,
+};
+
+
+/// \brief Parsed replacement field.
+///
+/// Replacement field has form `{[:[[fill]align][#][0][width][type]]}`, where
+/// align is one of `<`, `>` and `^`, and type is one of `d`, `x`, `X`, `c`,
+/// `s` and `p`.
+struct FormatField {
+	/// Position of `{` that starts the field.
+	uint16_t begin = 0;
+	/// Position next to `}` that ends the field.
+	uint16_t end = 0;
+	char fill = ' ';
+	FormatAlign align = FormatAlign::DEFAULT;
+	/// `#`: prefix hexadecimal numbers with `0x`.
+	bool alternate = false;
+	/// `0`: pad numbers with zeros after sign and prefix.
+	bool zero_pad = false;
+	uint8_t width = 0;
+	char type = '\0';
+};
+
+
+/// \brief Report error in format string.
+///
+/// The function isn't constexpr, so its call from the parser fails
+/// compilation with the reason in the diagnostic.
+void format_string_error(const char* reason);
+
+
+/// Parse specification of single field.
+consteval void parse_format_spec(const char* text, size_t& pos, size_t length,
+		FormatField& field)
+{
+	auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+	auto to_align = [](char c) {
+		switch (c) {
+		case '<': return FormatAlign::LEFT;
+		case '>': return FormatAlign::RIGHT;
+		default: return FormatAlign::CENTER;
+		}
+	};
+
+	if (pos + 1 < length && is_align(text[pos + 1]) && text[pos] != '}') {
+		field.fill = text[pos];
+		field.align = to_align(text[pos + 1]);
+		pos += 2;
+	} else if (pos < length && is_align(text[pos])) {
+		field.align = to_align(text[pos]);
+		++pos;
+	}
+	if (pos < length && text[pos] == '#') {
+		field.alternate = true;
+		++pos;
+	}
+	if (pos < length && text[pos] == '0') {
+		field.zero_pad = true;
+		++pos;
+	}
+	size_t width = 0;
+	while (pos < length && text[pos] >= '0' && text[pos] <= '9') {
+		width = width * 10 + (text[pos] - '0');
+		if (width > MAX_FORMAT_WIDTH) {
+			format_string_error("field width is too big");
+		}
+		++pos;
+	}
+	field.width = static_cast<uint8_t>(width);
+	if (pos < length && text[pos] != '}') {
+		field.type = text[pos];
+		++pos;
+	}
+	if (pos == length || text[pos] != '}') {
+		format_string_error("unterminated replacement field");
+	}
+}
+
+
+/// Check that specification of field is applicable to argument type.
+consteval void check_format_spec(const FormatField& field, FormatArgType type)
+{
+	const bool numeric_type = field.type == 'd' || field.type == 'x'
+		|| field.type == 'X';
+	const bool hex_type = field.type == 'x' || field.type == 'X';
+	switch (type) {
+	case FormatArgType::SIGNED:
+	case FormatArgType::UNSIGNED:
+		if (field.type != '\0' && !numeric_type) {
+			format_string_error("invalid type for integer");
+		}
+		break;
+	case FormatArgType::CHAR:
+		if (field.type != '\0' && field.type != 'c' && !numeric_type) {
+			format_string_error("invalid type for character");
+		}
+		break;
+	case FormatArgType::BOOL:
+	case FormatArgType::STRING:
+		if (field.type != '\0' && field.type != 's') {
+			format_string_error("invalid type for string");
+		}
+		break;
+	case FormatArgType::POINTER:
+		if (field.type != '\0' && field.type != 'p' && !hex_type) {
+			format_string_error("invalid type for pointer");
+		}
+		break;
+	case FormatArgType::CUSTOM:
+		if (field.end - field.begin != 2) {
+			format_string_error("only {} is supported for custom types");
+		}
+		return;
+	}
+	if (field.alternate && !(hex_type || type == FormatArgType::POINTER)) {
+		format_string_error("'#' is supported only for hexadecimal numbers");
+	}
+	const bool numeric_output = type == FormatArgType::SIGNED
+		|| type == FormatArgType::UNSIGNED
+		|| type == FormatArgType::POINTER
+		|| (type == FormatArgType::CHAR && numeric_type);
+	if (field.zero_pad && !numeric_output) {
+		format_string_error("'0' is supported only for numbers");
+	}
+}
+
+
+/// Type-erased argument.
+struct FormatArg {
+	FormatArgType type;
+	union {
+		char c;
+		bool b;
+		int32_t i;
+		uint32_t u;
+		const char* s;
+		const void* p;
+		struct {
+			const void* object;
+			void (*print)(ostream& out, const void* object);
+		} custom;
+	};
+};
+
+
+template<class T>
+void print_custom(ostream& out, const void* object)
+{
+	out << *static_cast<const T*>(object);
+}
+
+
+template<class T>
+FormatArg make_format_arg(const T& value)
+{
+	constexpr auto type = format_arg_type<T>();
+	FormatArg arg{type, {}};
+	if constexpr (type == FormatArgType::CHAR) {
+		arg.c = value;
+	} else if constexpr (type == FormatArgType::BOOL) {
+		arg.b = value;
+	} else if constexpr (type == FormatArgType::SIGNED) {
+		arg.i = value;
+	} else if constexpr (type == FormatArgType::UNSIGNED) {
+		arg.u = value;
+	} else if constexpr (type == FormatArgType::STRING) {
+		arg.s = value;
+	} else if constexpr (type == FormatArgType::POINTER) {
+		arg.p = value;
+	} else {
+		arg.custom.object = &value;
+		arg.custom.print = print_custom<T>;
+	}
+	return arg;
+}
+
+
+/// \brief Write formatted text to streambuf.
+///
+/// Literal text and fields are written in the order of format string.
+void vformat_to(streambuf& out, const char* text, size_t length,
+		const FormatField* fields, const FormatArg* args, size_t count);
+
+
+/// \brief Write formatted text to buffer.
+///
+/// \return Number of written characters without terminating null.
+size_t vformat_to(char* buffer, size_t size, const char* text, size_t length,
+		const FormatField* fields, const FormatArg* args, size_t count);
+
+
+} // namespace _impl
+
+
+/// \brief Format string checked at compile time.
+///
+/// The string is parsed when the object is constructed, so a malformed string,
+/// a wrong number of arguments or a specification that doesn't fit argument
+/// type fails compilation. Fields are replaced by arguments in order; `{{`
+/// and `}}` stand for braces.
+template<class ...Args>
+class basic_format_string {
+public:
+	template<size_t N>
+	consteval basic_format_string(const char (&text)[N])
+		: _text{text}, _length{N - 1}
+	{
+		constexpr _impl::FormatArgType types[] = {
+			_impl::format_arg_type<Args>()...,
+			_impl::FormatArgType::CUSTOM,
+		};
+		size_t count = 0;
+		size_t pos = 0;
+		while (pos < _length) {
+			if (text[pos] == '}') {
+				if (pos + 1 == _length || text[pos + 1] != '}') {
+					_impl::format_string_error("unmatched '}'");
+				}
+				pos += 2;
+				continue;
+			}
+			if (text[pos] != '{') {
+				++pos;
+				continue;
+			}
+			if (pos + 1 < _length && text[pos + 1] == '{') {
+				pos += 2;
+				continue;
+			}
+			if (count == sizeof...(Args)) {
+				_impl::format_string_error("too few arguments");
+			}
+			auto& field = _fields[count];
+			field.begin = static_cast<uint16_t>(pos);
+			++pos;
+			if (pos < _length && text[pos] == ':') {
+				++pos;
+				_impl::parse_format_spec(text, pos, _length, field);
+			} else if (pos == _length) {
+				_impl::format_string_error("unterminated replacement field");
+			} else if (text[pos] != '}') {
+				_impl::format_string_error("argument indexes aren't supported");
+			}
+			field.end = static_cast<uint16_t>(++pos);
+			_impl::check_format_spec(field, types[count]);
+			++count;
+		}
+		if (count != sizeof...(Args)) {
+			_impl::format_string_error("too many arguments");
+		}
+	}
+
+	const char* text() const { return _text; }
+
+	size_t length() const { return _length; }
+
+	const _impl::FormatField* fields() const { return _fields; }
+
+private:
+	const char* _text;
+	size_t _length;
+	_impl::FormatField _fields[sizeof...(Args) + 1] = {};
+};
+
+
+/// Format string for specified argument types.
+template<class ...Args>
+using format_string = basic_format_string<type_identity_t<Args>...>;
+
+
+/// \brief Write formatted text to streambuf.
+///
+/// \param out Output streambuf.
+/// \param fmt Format string.
+/// \param args Arguments to be formatted.
+template<class ...Args>
+void format_to(streambuf& out, format_string<Args...> fmt, const Args& ...args)
+{
+	const _impl::FormatArg format_args[] = {
+		_impl::make_format_arg(args)...,
+		_impl::FormatArg{_impl::FormatArgType::CUSTOM, {}},
+	};
+	_impl::vformat_to(out, fmt.text(), fmt.length(), fmt.fields(),
+		format_args, sizeof...(Args));
+}
+
+
+/// \brief Write formatted text to stream.
+///
+/// The text is written directly to streambuf of the stream, so the format
+/// flags of the stream are not used. A field width set on the stream is
+/// ignored and reset to zero, so it doesn't apply to the next insertion;
+/// padding is specified in the format string instead.
+template<class ...Args>
+ostream& format_to(ostream& out, format_string<Args...> fmt, const Args& ...args)
+{
+	out.width(0);
+	if (auto* sb = out.rdbuf()) {
+		format_to(*sb, fmt, args...);
+	}
+	return out;
+}
+
+
+/// \brief Write formatted text to buffer.
+///
+/// Text that doesn't fit into the buffer is dropped. The buffer is always
+/// terminated by null unless its size is zero.
+///
+/// \return Number of written characters without terminating null.
+template<class ...Args>
+size_t format_to(char* buffer, size_t size, format_string<Args...> fmt,
+		const Args& ...args)
+{
+	const _impl::FormatArg format_args[] = {
+		_impl::make_format_arg(args)...,
+		_impl::FormatArg{_impl::FormatArgType::CUSTOM, {}},
+	};
+	return _impl::vformat_to(buffer, size, fmt.text(), fmt.length(),
+		fmt.fields(), format_args, sizeof...(Args));
+}
+
+
+/// Write formatted text to array.
+template<size_t N, class ...Args>
+size_t format_to(char (&buffer)[N], format_string<Args...> fmt,
+		const Args& ...args)
+{
+	return format_to(static_cast<char*>(buffer), N, fmt, args...);
+}
+
+
+} // namespace lib
@@ -147,6 +147,19 @@ struct is_empty: lib::integral_constant<bool, __is_empty(T)> {};
 template<class T>
 constexpr inline bool is_empty_v = lib::is_empty<T>::value;
 
+
+/// \brief Identity type transformation.
+///
+/// The alias is used to exclude function parameter from template argument
+/// deduction.
+template<class T>
+struct type_identity {
+	using type = T;
+};
+
+template<class T>
+using type_identity_t = typename lib::type_identity<T>::type;
+
 } // namespace lib
 
 
@@ -2,6 +2,7 @@
 
 #include <bolgenos-ng/kernel_object.hpp>
 
+#include <cstdint.hpp>
 #include <ostream.hpp>
 #include <ext/scoped_format_guard.hpp>
 
@@ -99,8 +100,40 @@ void execinfo::show_backtrace(lib::ostream& out,
 }
 
 
-namespace {
+size_t execinfo::capture_backtrace(void **addresses, size_t max_depth,
+		void *ebp) {
+	// Frames of task stacks are outside of kernel stack, so a frame is
+	// only checked to be above the previous one and not too far from it.
+	constexpr lib::uintptr_t MAX_FRAME_SIZE = 64 * 1024;
 
+	if (ebp == nullptr) {
+		asm ("mov %%ebp, %%eax\n": "=a"(ebp):);
+	}
 
+	auto frame = static_cast<stack_frame_t *>(ebp);
+	size_t depth = 0;
+	while (depth < max_depth && is_inside_code(frame->return_address)) {
+		addresses[depth++] = frame->return_address;
 
-} // namespace
+		auto next = static_cast<stack_frame_t *>(frame->callers_ebp);
+		const auto from = reinterpret_cast<lib::uintptr_t>(frame);
+		const auto to = reinterpret_cast<lib::uintptr_t>(next);
+		if (to <= from || to - from > MAX_FRAME_SIZE) {
+			break;
+		}
+		frame = next;
+	}
+	return depth;
+}
+
+
+void execinfo::show_backtrace(lib::ostream& out, void * const *addresses,
+		size_t depth) {
+	lib::ScopedFormatGuard format_guard(out);
+
+	out	<< lib::hex;
+	for (size_t i = 0; i < depth; ++i) {
+		out << "\t#" << lib::dec << i << lib::hex << " eip = "
+			<< addresses[i] << lib::endl;
+	}
+}
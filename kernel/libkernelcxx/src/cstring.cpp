@@ -8,6 +8,16 @@ size_t strlen(const char *str) {
 	return length;
 }
 
+int strcmp(const char *s1, const char *s2) {
+	const auto* left = reinterpret_cast<const unsigned char *>(s1);
+	const auto* right = reinterpret_cast<const unsigned char *>(s2);
+	while (*left && *left == *right) {
+		++left;
+		++right;
+	}
+	return *left - *right;
+}
+
 char *strcpy(char *dest, const char *src) {
 	size_t pos = 0;
 	do {
@@ -37,3 +47,60 @@ void *memset(void *s, int c, size_t n) {
 	}
 	return s;
 }
+
+
+void *memcpy(void *dest, const void *src, size_t n) {
+	auto* to = static_cast<lib::byte *>(dest);
+	const auto* from = static_cast<const lib::byte *>(src);
+	while (n--) {
+		*(to++) = *(from++);
+	}
+	return dest;
+}
+
+
+void *memmove(void *dest, const void *src, size_t n) {
+	auto* to = static_cast<lib::byte *>(dest);
+	const auto* from = static_cast<const lib::byte *>(src);
+	size_t words = n / 4;
+	const size_t tail = n % 4;
+
+	if (to <= from || to >= from + n) {
+		asm volatile("rep movsl \n"
+			"movl %3, %%ecx \n"
+			"rep movsb \n"
+			: "+D"(to), "+S"(from), "+c"(words)
+			: "g"(tail)
+			: "memory");
+		return dest;
+	}
+
+	// Overlapping areas with destination above source are copied from
+	// the end.
+	for (size_t pos = n; pos != n - tail; --pos) {
+		to[pos - 1] = from[pos - 1];
+	}
+	if (words) {
+		to += n - tail - 4;
+		from += n - tail - 4;
+		asm volatile("std \n"
+			"rep movsl \n"
+			"cld \n"
+			: "+D"(to), "+S"(from), "+c"(words)
+			:
+			: "memory");
+	}
+	return dest;
+}
+
+
+int memcmp(const void *s1, const void *s2, size_t n) {
+	const auto* left = static_cast<const unsigned char *>(s1);
+	const auto* right = static_cast<const unsigned char *>(s2);
+	for (size_t pos = 0; pos != n; ++pos) {
+		if (left[pos] != right[pos]) {
+			return left[pos] < right[pos] ? -1 : 1;
+		}
+	}
+	return 0;
+}
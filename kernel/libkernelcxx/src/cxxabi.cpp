@@ -38,24 +38,52 @@ int __cxa_atexit(void (*destructor) (void *), void *arg, void *dso) {
 	return 0;
 }
 
-typedef lib::atomic<bool> __guard;
+/// \brief Guard of local static variable.
+///
+/// Compiler checks the first byte of the guard inline and calls
+/// \ref __cxa_guard_acquire only while it's zero, so the byte is set only
+/// after the variable is constructed. The second byte tells whether some
+/// task is constructing the variable right now.
+struct __guard {
+	lib::atomic<bool> initialized;
+	lib::atomic<uint8_t> state;
+};
+static_assert(sizeof(__guard) <= sizeof(uint64_t), "guard is too big");
+
+
+enum guard_state: uint8_t {
+	guard_idle	= 0,
+	guard_busy	= 1,
+	guard_done	= 2,
+};
+
 
 int __cxa_guard_acquire (__guard *g)
 {
-	if (g->compare_exchange(false, true)) {
-		return 1; // just to make sure that true is casted to 1
-	} else {
-		return 0;
+	while (true) {
+		uint8_t state = guard_idle;
+		if (g->state.compare_exchange_strong(state, guard_busy)) {
+			return 1;
+		}
+		if (state == guard_done) {
+			return 0;
+		}
+		// Another task is constructing the variable.
+		g->state.wait(guard_busy);
 	}
 }
 
-void __cxa_guard_release (__guard *g __attribute__((unused)))
+void __cxa_guard_release (__guard *g)
 {
+	g->initialized.store(true, lib::memory_order_release);
+	g->state.store(guard_done);
+	g->state.notify_all();
 }
 
 void __cxa_guard_abort (__guard *g)
 {
-	g->compare_exchange(true, false);
+	g->state.store(guard_idle);
+	g->state.notify_all();
 }
 
 void *__dso_handle = (void *)(0x0);
@@ -5,8 +5,32 @@
 #include <bolgenos-ng/asm.hpp>
 #include <bolgenos-ng/irq.hpp>
 
+namespace {
+
+constexpr int MAX_PANIC_NOTIFIERS = 4;
+
+void (*panic_notifiers[MAX_PANIC_NOTIFIERS])() = {};
+
+int panic_notifiers_count = 0;
+
+int panicking = 0;
+
+}
+
+void add_panic_notifier(void (*notifier)()) {
+	if (panic_notifiers_count == MAX_PANIC_NOTIFIERS) {
+		panic("too many panic notifiers");
+	}
+	panic_notifiers[panic_notifiers_count++] = notifier;
+}
+
 void panic(const char *msg) {
 	irq::disable();
+	if (!__atomic_exchange_n(&panicking, 1, __ATOMIC_SEQ_CST)) {
+		for (int i = 0; i < panic_notifiers_count; ++i) {
+			panic_notifiers[i]();
+		}
+	}
 	printk("Kernel Panic:\n");
 	if (msg != nullptr) {
 		printk(msg);
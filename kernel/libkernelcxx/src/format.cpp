@@ -0,0 +1,239 @@
+#include <format.hpp>
+
+#include <algorithm.hpp>
+#include <cstring.hpp>
+
+#include "integer_format.hpp"
+#include "streambuf.hpp"
+
+using namespace lib;
+using namespace lib::_impl;
+
+namespace {
+
+
+/// Size of buffer for formatted number together with padding.
+constexpr size_t FIELD_BUFFER_SIZE = MAX_FORMAT_WIDTH + 16;
+
+
+/// Fill characters are written by chunks of this size.
+constexpr size_t FILL_CHUNK_SIZE = 16;
+
+
+/// Streambuf that writes to fixed-size buffer and drops the rest.
+class BufferBuf: public streambuf {
+public:
+	BufferBuf(char* buffer, size_t size)
+		: _buffer{buffer}, _size{size}, _capacity{size ? size - 1 : 0}
+	{
+	}
+
+	BufferBuf(const BufferBuf&) = delete;
+	BufferBuf& operator=(const BufferBuf&) = delete;
+
+	/// Terminate the text by null and return its length.
+	size_t finish() {
+		if (_size) {
+			_buffer[_length] = '\0';
+		}
+		return _length;
+	}
+
+protected:
+	int overflow(int c) override {
+		if (_length != _capacity) {
+			_buffer[_length++] = static_cast<char>(c);
+		}
+		return c;
+	}
+
+	size_t xsputn(const char* s, size_t n) override {
+		const size_t length = lib::min(n, _capacity - _length);
+		memcpy(_buffer + _length, s, length);
+		_length += length;
+		return n;
+	}
+
+private:
+	char* _buffer;
+	size_t _size;
+	size_t _capacity;
+	size_t _length = 0;
+};
+
+
+void write_fill(streambuf& out, char fill, size_t count)
+{
+	char chunk[FILL_CHUNK_SIZE];
+	lib::fill_n(chunk, lib::min(count, sizeof(chunk)), fill);
+	while (count != 0) {
+		const size_t length = lib::min(count, sizeof(chunk));
+		out.sputn(chunk, length);
+		count -= length;
+	}
+}
+
+
+/// \brief Write literal text between fields.
+///
+/// Escaped braces are validated by format string, so every brace here is
+/// followed by the same one.
+void write_literal(streambuf& out, const char* text, size_t begin, size_t end)
+{
+	size_t run = begin;
+	for (size_t pos = begin; pos < end; ++pos) {
+		if (text[pos] == '{' || text[pos] == '}') {
+			out.sputn(text + run, pos + 1 - run);
+			run = ++pos + 1;
+		}
+	}
+	if (run < end) {
+		out.sputn(text + run, end - run);
+	}
+}
+
+
+void write_aligned(streambuf& out, const FormatField& field, const char* text,
+		size_t length, FormatAlign default_align)
+{
+	if (field.width <= length) {
+		out.sputn(text, length);
+		return;
+	}
+
+	const size_t padding = field.width - length;
+	const auto align = field.align == FormatAlign::DEFAULT
+		? default_align : field.align;
+	size_t before = 0;
+	switch (align) {
+	case FormatAlign::RIGHT:
+		before = padding;
+		break;
+	case FormatAlign::CENTER:
+		before = padding / 2;
+		break;
+	default:
+		break;
+	}
+	write_fill(out, field.fill, before);
+	out.sputn(text, length);
+	write_fill(out, field.fill, padding - before);
+}
+
+
+/// \brief Write number.
+///
+/// Right-aligned number is padded in the same buffer, so it's written by
+/// single `sputn`.
+void write_number(streambuf& out, const FormatField& field, uint32_t magnitude,
+		bool negative, bool hex, bool prefix)
+{
+	char buffer[FIELD_BUFFER_SIZE];
+	char* const end = buffer + sizeof(buffer);
+	char* begin = nullptr;
+	if (hex) {
+		begin = format_hex(magnitude, end,
+			field.type == 'X' ? UPPER_HEX_DIGITS : HEX_DIGITS);
+	} else {
+		begin = format_decimal(magnitude, end);
+	}
+
+	const size_t prefix_length = (negative ? 1 : 0) + (prefix ? 2 : 0);
+	const size_t length = end - begin + prefix_length;
+	if (field.zero_pad && field.width > length) {
+		const size_t zeros = field.width - length;
+		begin -= zeros;
+		lib::fill_n(begin, zeros, '0');
+	}
+	if (prefix) {
+		*--begin = field.type == 'X' ? 'X' : 'x';
+		*--begin = '0';
+	}
+	if (negative) {
+		*--begin = '-';
+	}
+
+	const auto align = field.align;
+	if (align != FormatAlign::DEFAULT && align != FormatAlign::RIGHT) {
+		write_aligned(out, field, begin, end - begin, FormatAlign::RIGHT);
+		return;
+	}
+	const size_t field_length = end - begin;
+	if (field.width > field_length) {
+		const size_t padding = field.width - field_length;
+		begin -= padding;
+		lib::fill_n(begin, padding, field.fill);
+	}
+	out.sputn(begin, end - begin);
+}
+
+
+void write_arg(streambuf& out, const FormatField& field, const FormatArg& arg)
+{
+	const bool hex = field.type == 'x' || field.type == 'X';
+	const bool numeric = hex || field.type == 'd';
+	switch (arg.type) {
+	case FormatArgType::CHAR:
+		if (numeric) {
+			write_number(out, field, static_cast<unsigned char>(arg.c),
+				false, hex, field.alternate);
+		} else {
+			write_aligned(out, field, &arg.c, 1, FormatAlign::LEFT);
+		}
+		break;
+	case FormatArgType::BOOL: {
+		const char* text = arg.b ? "true" : "false";
+		write_aligned(out, field, text, strlen(text), FormatAlign::LEFT);
+		break;
+	}
+	case FormatArgType::SIGNED: {
+		const bool negative = arg.i < 0;
+		write_number(out, field, negative ? 0u - arg.u : arg.u, negative,
+			hex, field.alternate);
+		break;
+	}
+	case FormatArgType::UNSIGNED:
+		write_number(out, field, arg.u, false, hex, field.alternate);
+		break;
+	case FormatArgType::STRING: {
+		const char* text = arg.s ? arg.s : "(null)";
+		write_aligned(out, field, text, strlen(text), FormatAlign::LEFT);
+		break;
+	}
+	case FormatArgType::POINTER:
+		write_number(out, field, reinterpret_cast<uint32_t>(arg.p), false,
+			true, field.alternate || !hex);
+		break;
+	case FormatArgType::CUSTOM: {
+		ostream stream{&out};
+		arg.custom.print(stream, arg.custom.object);
+		break;
+	}
+	}
+}
+
+
+} // namespace
+
+
+void lib::_impl::vformat_to(streambuf& out, const char* text, size_t length,
+		const FormatField* fields, const FormatArg* args, size_t count)
+{
+	size_t pos = 0;
+	for (size_t i = 0; i < count; ++i) {
+		write_literal(out, text, pos, fields[i].begin);
+		write_arg(out, fields[i], args[i]);
+		pos = fields[i].end;
+	}
+	write_literal(out, text, pos, length);
+}
+
+
+size_t lib::_impl::vformat_to(char* buffer, size_t size, const char* text,
+		size_t length, const FormatField* fields, const FormatArg* args,
+		size_t count)
+{
+	BufferBuf out{buffer, size};
+	vformat_to(out, text, length, fields, args, count);
+	return out.finish();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef.hpp>
+
+namespace lib::_impl {
+
+
+/// Decimal representations of numbers from 00 to 99.
+struct DigitPairs {
+	constexpr DigitPairs() {
+		for (size_t i = 0; i < 100; ++i) {
+			text[2 * i] = static_cast<char>('0' + i / 10);
+			text[2 * i + 1] = static_cast<char>('0' + i % 10);
+		}
+	}
+
+	char text[200] = {};
+};
+
+
+inline constexpr DigitPairs DIGIT_PAIRS{};
+
+
+inline constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+
+inline constexpr char UPPER_HEX_DIGITS[] = "0123456789ABCDEF";
+
+
+/// \brief Format decimal number.
+///
+/// Two digits are converted per division.
+///
+/// \param value Number to be formatted.
+/// \param end End of output buffer.
+/// \return Beginning of formatted number.
+template<typename T>
+char* format_decimal(T value, char* end) {
+	while (value >= 100) {
+		const char* pair = &DIGIT_PAIRS.text[2 * (value % 100)];
+		value /= 100;
+		end -= 2;
+		end[0] = pair[0];
+		end[1] = pair[1];
+	}
+	if (value >= 10) {
+		const char* pair = &DIGIT_PAIRS.text[2 * value];
+		end -= 2;
+		end[0] = pair[0];
+		end[1] = pair[1];
+	} else {
+		*--end = static_cast<char>('0' + value);
+	}
+	return end;
+}
+
+
+/// \brief Format hexadecimal number.
+///
+/// \param value Number to be formatted.
+/// \param end End of output buffer.
+/// \param digits Table of hexadecimal digits.
+/// \return Beginning of formatted number.
+template<typename T>
+char* format_hex(T value, char* end, const char* digits = HEX_DIGITS) {
+	do {
+		*--end = digits[value & 0xf];
+		value >>= 4;
+	} while (value);
+	return end;
+}
+
+
+} // namespace lib::_impl
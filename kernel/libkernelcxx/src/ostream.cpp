@@ -1,9 +1,11 @@
 #include <ostream.hpp>
 
+#include <algorithm.hpp>
 #include <cstring.hpp>
 #include <type_traits.hpp>
 #include <utility.hpp>
 
+#include "integer_format.hpp"
 #include "streambuf.hpp"
 
 using namespace lib;
@@ -51,10 +53,7 @@ lib::ostream& lib::ostream::operator <<(char val) {
 lib::ostream& lib::ostream::operator <<(const char *string) {
 	size_t len = strlen(string);
 	fill_field(*this, width_, len);
-	while (*string) {
-		put(*string);
-		++string;
-	}
+	write(string, len);
 	return *this;
 }
 
@@ -239,23 +238,43 @@ lib::_impl::_setfill_type lib::setfill(char fillch) {
 namespace {
 
 
+/// Size of buffer for formatted number together with padding.
+constexpr size_t FIELD_BUFFER_SIZE = 32;
+
+
+/// Fill characters are written by chunks of this size.
+constexpr size_t FILL_CHUNK_SIZE = 16;
+
+
 void fill_field(lib::ostream& stream, size_t width, size_t already_have) {
-	char fillch = stream.fill();
-	while (width-- > already_have) {
-		stream.put(fillch);
+	if (width <= already_have) {
+		return;
+	}
+	char chunk[FILL_CHUNK_SIZE];
+	lib::fill_n(chunk, sizeof(chunk), stream.fill());
+	for (size_t left = width - already_have; left != 0; ) {
+		const size_t length = lib::min(left, sizeof(chunk));
+		stream.write(chunk, length);
+		left -= length;
 	}
 }
 
 
-constexpr size_t MAX_DEC_LENGTH = 20 + 1 /* sign */;
-
-
-char to_printable(unsigned char digit) {
-	if (digit < 10) {
-		return '0' + digit;
+/// \brief Write field that is formatted at the end of buffer.
+///
+/// Padding is put in front of the text in the same buffer if it fits, so
+/// the field is written by single \ref lib::ostream::write.
+void show_field(lib::ostream& stream, char* buffer, char* begin, char* end) {
+	const size_t length = end - begin;
+	const size_t width = stream.width();
+	if (width > length && width - length <= static_cast<size_t>(begin - buffer)) {
+		const size_t padding = width - length;
+		begin -= padding;
+		lib::fill_n(begin, padding, stream.fill());
 	} else {
-		return 'a' + digit - 10;
+		fill_field(stream, width, length);
 	}
+	stream.write(begin, end - begin);
 }
 
 
@@ -264,42 +283,23 @@ void show_numerical_value(lib::ostream& stream, T value) {
 	using value_type = T;
 	using unsigned_value_type = typename make_unsigned<value_type>::type;
 
-	unsigned_value_type unsigned_value = 0;
-	unsigned_value_type base = 10;
+	char buffer[FIELD_BUFFER_SIZE];
+	char* const end = buffer + sizeof(buffer);
+	char* begin = nullptr;
+
+	auto unsigned_value = static_cast<unsigned_value_type>(value);
 	auto basefield = stream.flags() & lib::ostream::fmtflags::basefield;
 	if (basefield == lib::ostream::fmtflags::hex) {
-		unsigned_value = static_cast<unsigned_value_type>(value);
-		base = 16;
+		begin = _impl::format_hex(unsigned_value, end);
+	} else if (is_signed<value_type>::value && value < 0) {
+		begin = _impl::format_decimal(
+			static_cast<unsigned_value_type>(0 - unsigned_value), end);
+		*--begin = '-';
 	} else {
-		if (value >= 0) {
-			unsigned_value = static_cast<unsigned_value_type>(value);
-		} else {
-			unsigned_value = static_cast<unsigned_value_type>(0) - value;
-		}
+		begin = _impl::format_decimal(unsigned_value, end);
 	}
 
-	char buffer[MAX_DEC_LENGTH];
-	size_t digits = 0;
-
-	while (unsigned_value) {
-		unsigned char digit = unsigned_value % base;
-		buffer[digits++] = to_printable(digit);
-		unsigned_value /= base;
-	}
-
-	if (digits == 0) {
-		buffer[digits++] = '0';
-	}
-
-	if (basefield == lib::ostream::fmtflags::dec && value < 0) {
-		buffer[digits++] = '-';
-	}
-
-	fill_field(stream, stream.width(), digits);
-
-	do {
-		stream.put(buffer[--digits]);
-	} while(digits);
+	show_field(stream, buffer, begin, end);
 }
 
 
@@ -3,26 +3,142 @@
 #include <bolgenos-ng/asm.hpp>
 #include <bolgenos-ng/error.h>
 #include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/tick.hpp>
 #include <sched.hpp>
+#include <threading/seqlock.hpp>
 
 #include "config.h"
 
 lib::atomic<uint32_t> jiffies{0};
 
 
-void sleep_(uint32_t ticks_timeout) {
+namespace {
+
+
+/// Shift of fixed-point multipliers used for conversions.
+constexpr unsigned CONVERSION_SHIFT = 24;
+
+
+/// \brief Parameters of TSC-based clock.
+struct tsc_clock_t {
+	/// TSC value at zero of monotonic clock.
+	uint64_t reference;
+	/// Nanoseconds per cycle multiplied by 2^CONVERSION_SHIFT.
+	uint32_t ns_mult;
+	/// Cycles per nanosecond multiplied by 2^CONVERSION_SHIFT.
+	uint32_t cycles_mult;
+	/// TSC frequency.
+	uint32_t khz;
+};
+
+
+tsc_clock_t tsc_clock {0, 0, 0, 0};
+
+
+/// \brief Lock that publishes \ref tsc_clock.
+///
+/// Parameters may be updated after recalibration while readers, including
+/// interrupt handlers, use them.
+thr::SeqLock tsc_clock_lock{"tsc_clock"};
+
+
+tsc_clock_t read_tsc_clock()
+{
+	return tsc_clock_lock.read([]() { return tsc_clock; });
+}
+
+
+} // namespace
+
+
+void time::details::init_tsc(uint32_t khz, uint64_t reference)
+{
+	uint64_t ns_mult = NSEC_PER_MSEC << CONVERSION_SHIFT;
+	x86::div64(ns_mult, khz);
+
+	uint64_t cycles_mult = static_cast<uint64_t>(khz) << CONVERSION_SHIFT;
+	x86::div64(cycles_mult, NSEC_PER_MSEC);
+
+	tsc_clock_lock.write([&]() {
+		tsc_clock.reference = reference;
+		tsc_clock.ns_mult = static_cast<uint32_t>(ns_mult);
+		tsc_clock.cycles_mult = static_cast<uint32_t>(cycles_mult);
+		tsc_clock.khz = khz;
+	});
+}
+
+
+uint64_t time::cycles()
+{
+	return x86::read_tsc();
+}
+
+
+uint64_t time::cycles_to_ns(uint64_t cycles)
+{
+	return x86::mul_shr(cycles, read_tsc_clock().ns_mult, CONVERSION_SHIFT);
+}
+
+
+uint64_t time::ns_to_cycles(uint64_t ns)
+{
+	return x86::mul_shr(ns, read_tsc_clock().cycles_mult, CONVERSION_SHIFT);
+}
+
+
+uint32_t time::tsc_khz()
+{
+	return read_tsc_clock().khz;
+}
+
+
+uint64_t time::now_ns()
+{
+	const tsc_clock_t clock = read_tsc_clock();
+	return x86::mul_shr(x86::read_tsc() - clock.reference, clock.ns_mult,
+		CONVERSION_SHIFT);
+}
+
+
+uint64_t time::now_us()
+{
+	uint64_t now = now_ns();
+	x86::div64(now, NSEC_PER_USEC);
+	return now;
+}
+
+
+uint64_t time::now_ms()
+{
+	uint64_t now = now_ns();
+	x86::div64(now, NSEC_PER_MSEC);
+	return now;
+}
+
+
+void time::sleep_ns(uint64_t ns) {
 	if (!irq::is_enabled()) {
 		panic("sleep with disabled interrupts");
 	}
-	uint32_t end_of_sleep = jiffies.load() + ticks_timeout;
-	while (jiffies.load() < end_of_sleep) {
-		sched::yield();
+	const uint64_t end_of_sleep = now_ns() + ns;
+	while (now_ns() < end_of_sleep) {
+		if (sched::current()) {
+			sched::sleep_until(end_of_sleep);
+		} else {
+			tick::request_event(end_of_sleep);
+			tick::idle();
+		}
 	}
 }
 
 
+void time::sleep_us(uint64_t us) {
+	sleep_ns(us * NSEC_PER_USEC);
+}
+
+
 void sleep_ms(uint32_t ms) {
-	sleep_(ms_to_ticks(ms));
+	time::sleep_ns(ms * time::NSEC_PER_MSEC);
 }
 
 
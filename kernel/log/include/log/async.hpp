@@ -0,0 +1,50 @@
+#pragma once
+
+#include "sink.hpp"
+
+/// \brief Asynchronous logging.
+///
+/// Once started, log streams don't write to sinks in caller context. They
+/// put finished records into ring buffer of the current CPU and return; a
+/// low-priority kernel task drains the rings to sinks. The task sleeps
+/// while rings are empty and is woken by producers. Records that don't
+/// fit into a full ring are dropped and counted. Before \ref start is
+/// called, log streams are synchronous.
+namespace log::async {
+
+
+/// Check if logging is asynchronous.
+bool is_active();
+
+
+/// \brief Put record to ring of the current CPU.
+///
+/// The record is dropped if the ring is full.
+void submit(const log::Record& record);
+
+
+/// \brief Wake up drain task after push to ring.
+///
+/// Drain task is woken only when the ring becomes non-empty or half full, so
+/// that most pushes don't touch scheduler.
+///
+/// \param queued Number of elements in the ring after push.
+/// \param capacity Capacity of the ring.
+void wake_up(size_t queued, size_t capacity);
+
+
+/// \brief Switch logging to asynchronous mode.
+///
+/// Function starts drain task, so scheduling must be started. Does nothing
+/// if ASYNC_LOG option is disabled.
+void start();
+
+
+/// \brief Write all pending records in caller context.
+///
+/// The function is called by \ref panic; logging becomes synchronous after
+/// it.
+void flush();
+
+
+} // namespace log::async
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+#include <type_traits.hpp>
+
+#include <log_level.hpp>
+
+/// \brief Binary logging.
+///
+/// Call site of binary log records only ID of its format and raw arguments;
+/// text is formatted on host by `tools/logdecode`. Formats are kept in
+/// `.log_formats` section of kernel image, ID of format is its address.
+///
+/// Records are written to COM1 as frames:
+///
+///	0xff 0xb1 cpu:u8 words:u8 format:u32 tsc:u64 args:u32[words]
+///
+/// All numbers are little-endian. Frames are mixed with text log, which is
+/// expected to never contain byte 0xff.
+///
+/// Formats support `%d`, `%u`, `%x`, `%p` and `%c` for 32-bit arguments,
+/// `%lld`, `%llu` and `%llx` for 64-bit ones, and `%%`.
+namespace log::binary {
+
+
+/// First bytes of every frame.
+constexpr uint8_t FRAME_MAGIC[] = {0xff, 0xb1};
+
+
+/// Maximal number of 32-bit words of arguments.
+constexpr size_t MAX_WORDS = 8;
+
+
+/// \brief Format in `.log_formats` section.
+///
+/// \warning Layout is read by `tools/logdecode`.
+template<size_t Length>
+struct alignas(4) Format {
+	uint8_t level;
+	/// Number of 32-bit words of arguments.
+	uint8_t words;
+	/// Length of text without terminating zero.
+	uint16_t length;
+	char text[Length + 1];
+};
+
+
+/// Number of 32-bit words of arguments expected by format.
+template<char ...Chars>
+constexpr size_t format_words()
+{
+	constexpr char text[] = {Chars..., 0};
+	size_t words = 0;
+	for (size_t i = 0; text[i]; ++i) {
+		if (text[i] != '%') {
+			continue;
+		}
+		++i;
+		if (text[i] == '%') {
+			continue;
+		}
+		size_t longs = 0;
+		for (; text[i] == 'l'; ++i) {
+			++longs;
+		}
+		words += longs >= 2 ? 2 : 1;
+	}
+	return words;
+}
+
+
+/// \brief Holder of format of call site.
+///
+/// Every format is emitted by compiler into its own COMDAT section named
+/// after the holder; kernel.ld collects such sections into `.log_formats`.
+template<lib::LogLevel Level, char ...Chars>
+struct FormatHolder {
+	static constexpr Format<sizeof...(Chars)> format{
+		static_cast<uint8_t>(Level),
+		static_cast<uint8_t>(format_words<Chars...>()),
+		sizeof...(Chars),
+		{Chars..., 0}
+	};
+};
+
+
+/// Recorded call.
+struct Event {
+	uint32_t format;
+	uint8_t cpu;
+	uint8_t words;
+	uint64_t tsc;
+	uint32_t args[MAX_WORDS];
+};
+
+
+/// Number of 32-bit words taken by argument.
+template<class T>
+constexpr size_t arg_words()
+{
+	return sizeof(T) > sizeof(uint32_t) ? 2 : 1;
+}
+
+
+template<class T>
+inline void put_arg(Event& event, T value)
+{
+	if constexpr (lib::is_pointer_v<T>) {
+		event.args[event.words++] = reinterpret_cast<uint32_t>(value);
+	} else if constexpr (sizeof(T) > sizeof(uint32_t)) {
+		const auto wide = static_cast<uint64_t>(value);
+		event.args[event.words++] = static_cast<uint32_t>(wide);
+		event.args[event.words++] = static_cast<uint32_t>(wide >> 32);
+	} else {
+		event.args[event.words++] = static_cast<uint32_t>(value);
+	}
+}
+
+
+/// Fill CPU and time of event and pass it to ring or to serial port.
+void submit(Event& event);
+
+
+/// \brief Write frames of all CPUs to serial port.
+///
+/// Function is called by drain task of \ref log::async.
+void drain();
+
+
+/// \brief Record call.
+///
+/// Only stores are done in caller context; formatting is left to host.
+template<lib::LogLevel Level, char ...Chars, class ...Args>
+inline void record(Args ...args)
+{
+	static_assert(format_words<Chars...>() == (0 + ... + arg_words<Args>()),
+		"arguments don't match the format");
+	static_assert(format_words<Chars...>() <= MAX_WORDS,
+		"too many arguments");
+
+	Event event;
+	event.format = reinterpret_cast<uint32_t>(
+		&FormatHolder<Level, Chars...>::format);
+	event.words = 0;
+	(put_arg(event, args), ...);
+	submit(event);
+}
+
+
+} // namespace log::binary
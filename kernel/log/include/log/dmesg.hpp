@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef.hpp>
+
+namespace lib {
+class ostream;
+}
+
+namespace log {
+
+struct Record;
+
+namespace dmesg {
+
+
+/// \brief Append record to dmesg buffer.
+///
+/// The buffer has fixed size of DMESG_SIZE bytes; the oldest text is
+/// overwritten when it's full.
+void write(const Record& record);
+
+
+/// \brief Copy the latest text of dmesg buffer.
+///
+/// \param buffer Output buffer.
+/// \param size Size of output buffer.
+/// \return Number of copied characters.
+size_t read(char* buffer, size_t size);
+
+
+/// Write content of dmesg buffer to the stream.
+void dump(lib::ostream& out);
+
+
+/// \brief Dump dmesg buffer to serial console on panic.
+///
+/// Panic notifiers are called in order of registration, so the function must
+/// be called after the serial port is switched to interrupt mode: the dump is
+/// written when the port is polled again. Does nothing unless DMESG_ON_PANIC
+/// is enabled.
+void dump_on_panic();
+
+
+} // namespace dmesg
+
+} // namespace log
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <format.hpp>
+#include <ostream.hpp>
+
+#include <log_level.hpp>
+
+namespace log {
+
+
+/// Stream that drops everything written to it.
+lib::ostream& null_stream();
+
+
+/// \brief Start log statement.
+///
+/// \param level Level of the statement.
+/// \param prefix Prefix of the line if the statement starts a new line.
+/// \return Stream of the line of current context.
+lib::ostream& begin_line(lib::LogLevel level, const char* prefix);
+
+
+/// \brief Single log statement.
+///
+/// The line decides once whether the message is printed. If it isn't, every
+/// `operator<<` is a check of the same null pointer, which compiler folds
+/// into one branch, and nothing is formatted. Lines of levels that aren't
+/// compiled in do nothing at all.
+template<lib::LogLevel Level>
+class LogLine {
+public:
+	constexpr explicit LogLine(lib::ostream* stream)
+		: _stream{stream}
+	{
+	}
+
+	template<class T>
+	const LogLine& operator<<(const T& value) const {
+		if constexpr (lib::is_compiled(Level)) {
+			if (_stream) {
+				*_stream << value;
+			}
+		}
+		return *this;
+	}
+
+	const LogLine& operator<<(lib::ostream::manipulator_type manipulator) const {
+		if constexpr (lib::is_compiled(Level)) {
+			if (_stream) {
+				*_stream << manipulator;
+			}
+		}
+		return *this;
+	}
+
+private:
+	lib::ostream* _stream;
+};
+
+
+/// \brief Log stream of specific level.
+///
+/// Channel refers to the prefix of a logger and to its enabled level, which
+/// is checked once per statement by the first `operator<<`.
+template<lib::LogLevel Level>
+class LogChannel {
+public:
+	constexpr LogChannel(const char* prefix, const lib::LogLevel& enabled_level)
+		: _prefix{prefix}, _enabled_level{&enabled_level}
+	{
+	}
+
+	/// Check if messages of the channel are printed.
+	[[nodiscard]]
+	bool enabled() const {
+		if constexpr (lib::is_compiled(Level)) {
+			return Level <= *_enabled_level;
+		} else {
+			return false;
+		}
+	}
+
+	[[nodiscard]]
+	LogLine<Level> line() const {
+		return LogLine<Level>{enabled() ? &begin_line(Level, _prefix) : nullptr};
+	}
+
+	template<class T>
+	LogLine<Level> operator<<(const T& value) const {
+		auto result = line();
+		result << value;
+		return result;
+	}
+
+	LogLine<Level> operator<<(lib::ostream::manipulator_type manipulator) const {
+		auto result = line();
+		result << manipulator;
+		return result;
+	}
+
+	/// \brief Print formatted line.
+	///
+	/// Arguments are formatted by \ref lib::format_to only if the level is
+	/// enabled. Line feed is appended to the text.
+	template<class ...Args>
+	void format(lib::format_string<Args...> fmt, const Args& ...args) const {
+		if (enabled()) {
+			auto& out = begin_line(Level, _prefix);
+			lib::format_to(out, fmt, args...);
+			out << lib::endl;
+		}
+	}
+
+	/// \brief Stream for functions that print to ostream.
+	///
+	/// \return Stream of the line or \ref null_stream if the level is
+	///	disabled.
+	operator lib::ostream&() const {
+		return enabled() ? begin_line(Level, _prefix) : null_stream();
+	}
+
+private:
+	const char* _prefix;
+	const lib::LogLevel* _enabled_level;
+};
+
+
+} // namespace log
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <streambuf.hpp>
-#include <serial/serial_port.hpp>
 #include "simple_stream_buf.hpp"
-#include "delegating_log_buf.hpp"
+
+namespace serial {
+class Uart;
+}
 
 class SerialBuf: public SimpleStreamBuf<lib::streambuf>
 {
 public:
-	explicit SerialBuf(serial::SerialPort port);
+	/// Construct buffer writing to COM1.
+	SerialBuf();
+
+	explicit SerialBuf(serial::Uart& uart);
 
 	int overflow(int c) override;
 private:
-	serial::SerialPort _port;
+	serial::Uart& _uart;
 };
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace lib {
+class ostream;
+}
+
+namespace log {
+
+/// \brief Stream of serial console.
+///
+/// The stream writes to COM1 without prefixes and log levels. It's used for
+/// dumps of kernel state, e.g. \ref irq::InterruptsManager::print_stats.
+lib::ostream& serial_console();
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+
+#include <log_level.hpp>
+
+namespace log {
+
+
+/// Maximal length of record including prefix and line feed.
+constexpr size_t RECORD_SIZE = 120;
+
+
+/// \brief Log line.
+///
+/// Lines longer than \ref RECORD_SIZE are split into several records.
+struct Record {
+	lib::LogLevel level;
+	uint8_t length;
+	char text[RECORD_SIZE];
+};
+
+
+/// \brief Destination of log records.
+///
+/// All loggers write to the same sinks. VGA console, COM1, QEMU debug console
+/// and dmesg buffer are registered at first use of the registry; they are set
+/// up once for all loggers. Each sink gets only records that are at least as
+/// important as its level.
+class Sink {
+public:
+	explicit Sink(lib::LogLevel level)
+		: _level{level} {
+	}
+
+	virtual ~Sink() = default;
+
+	virtual void write(const Record& record) = 0;
+
+	/// Check if the sink accepts records of specified level.
+	bool accepts(lib::LogLevel level) const {
+		return level <= _level;
+	}
+
+	/// Set the least important level that is written to the sink.
+	void level(lib::LogLevel level) {
+		_level = level;
+	}
+
+private:
+	lib::LogLevel _level;
+};
+
+
+/// Maximal number of sinks.
+constexpr size_t MAX_SINKS = 8;
+
+
+/// \brief Register sink.
+///
+/// Sinks are never removed, so the sink must live forever.
+void add_sink(Sink* sink);
+
+
+/// \brief Write record to all sinks.
+///
+/// Sinks are called under spinlock with disabled interrupts, so they get
+/// one record at a time.
+void write_to_sinks(const Record& record);
+
+
+/// \brief Write raw bytes to COM1.
+///
+/// Bytes are written under the same lock as records, so text records can't
+/// get into the middle of them. Line feeds aren't translated.
+void write_raw_to_serial(const void* data, size_t size);
+
+
+} // namespace log
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "config.h"
+
 namespace lib {
 
 /// Logging level type.
@@ -12,4 +14,17 @@ enum class LogLevel {
 	DEBUG		= 5,
 };
 
+
+/// \brief The least important level that is compiled in.
+///
+/// Log statements of less important levels are removed at compile time
+/// regardless of level of their logger.
+constexpr LogLevel COMPILED_LOG_LEVEL = static_cast<LogLevel>(LOG_LEVEL);
+
+
+/// Check if messages of specified level are compiled in.
+constexpr bool is_compiled(LogLevel level) {
+	return level <= COMPILED_LOG_LEVEL;
+}
+
 }
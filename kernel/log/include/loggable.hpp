@@ -24,12 +24,14 @@ private:
 	using prefix = lib::basic_static_string<Char, Chars...>;
 	static ::lib::StaticLogger<prefix> _local_logger;
 protected:
-	static auto& DEBUG = _local_logger.debug();
-	static auto& INFO = _local_logger.info();
-	static auto& NOTICE = _local_logger.notice();
-	static auto& WARN = _local_logger.warning();
-	static auto& ERROR = _local_logger.error();
-	static auto& CRIT = _local_logger.critical();
+	static constexpr auto DEBUG = _local_logger.debug();
+	static constexpr auto INFO = _local_logger.info();
+	static constexpr auto NOTICE = _local_logger.notice();
+	static constexpr auto WARN = _local_logger.warning();
+	static constexpr auto ERROR = _local_logger.error();
+	static constexpr auto CRIT = _local_logger.critical();
+	/// Logger that is used by BLOG_* statements.
+	static constexpr const auto& local_logger = _local_logger;
 };
 
 template<class Char, char ...Chars>
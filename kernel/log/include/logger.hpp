@@ -1,69 +1,54 @@
 #pragma once
 
 #include <ostream.hpp>
-#include <memory.hpp>
+#include <static_string.hpp>
 
 #include "log_level.hpp"
-#include "log/composite_buf.hpp"
-#include "log/serial_buf.hpp"
-#include "log/static_serial_log_buf.hpp"
+#include "log/binary.hpp"
+#include "log/log_channel.hpp"
+
+#include "config.h"
 
 namespace lib {
 
 template<class Char, Char ...Chars>
 class StaticLogger;
 
+/// \brief Logger.
+///
+/// Logger is a lightweight handle of a prefix and a level; all loggers write
+/// to shared sinks, see \ref log::Sink.
 template<class Char, Char ...Chars>
 class StaticLogger<lib::basic_static_string<Char, Chars...>> {
 	using prefix = lib::basic_static_string<Char, Chars...>;
 public:
-	explicit StaticLogger(const prefix&, LogLevel level) :
-		_log_level{level},
-		_streambufs{_log_level}
+	constexpr explicit StaticLogger(const prefix&, LogLevel level) :
+		_log_level{level}
 	{}
 	constexpr ~StaticLogger() = default;
-	constexpr lib::ostream& debug() const { return _debug; }
-	constexpr lib::ostream& info() const { return _info; }
-	constexpr lib::ostream& notice() const { return _notice; }
-	constexpr lib::ostream& warning() const { return _warning; }
-	constexpr lib::ostream& error() const { return _error; }
-	constexpr lib::ostream& critical() const { return _critical; }
-
-private:
-	lib::LogLevel _log_level;
+	constexpr log::LogChannel<LogLevel::DEBUG> debug() const { return {_prefix, _log_level}; }
+	constexpr log::LogChannel<LogLevel::INFO> info() const { return {_prefix, _log_level}; }
+	constexpr log::LogChannel<LogLevel::NOTICE> notice() const { return {_prefix, _log_level}; }
+	constexpr log::LogChannel<LogLevel::WARNING> warning() const { return {_prefix, _log_level}; }
+	constexpr log::LogChannel<LogLevel::ERROR> error() const { return {_prefix, _log_level}; }
+	constexpr log::LogChannel<LogLevel::CRITICAL> critical() const { return {_prefix, _log_level}; }
 
-	using serial_sb = log::StaticSerialLogBuf<prefix>;
-	using vga_sb = log::StaticVgaDelegatingLogBuf<prefix>;
-	using streambuf_type = CompositeBuf<vga_sb, serial_sb>;
-	constexpr static auto _prefix = prefix{};
-
-	static streambuf_type build_sb(lib::LogLevel level, lib::LogLevel& conf) {
-		return {vga_sb{level, _prefix, conf, log::color(level)}, serial_sb{level, _prefix, conf}};
+	/// \brief Record binary log event, see \ref log::binary.
+	///
+	/// Format of the event is the prefix of logger followed by \p format.
+	template<LogLevel Level, Char ...Format, class ...Args>
+	void binary(lib::basic_static_string<Char, Format...>, Args ...args) const {
+		if constexpr (BINARY_LOG && lib::is_compiled(Level)) {
+			if (Level <= _log_level) {
+				log::binary::record<Level, Chars..., Format...>(args...);
+			}
+		}
 	}
 
-	struct SbHolder {
-		SbHolder(lib::LogLevel& conf)
-			: debug{build_sb(LogLevel::DEBUG, conf)}
-			, info{build_sb(LogLevel::INFO, conf)}
-			, notice{build_sb(LogLevel::NOTICE, conf)}
-			, warning{build_sb(LogLevel::WARNING, conf)}
-			, error{build_sb(LogLevel::ERROR, conf)}
-			, critical{build_sb(LogLevel::CRITICAL, conf)}
-		{}
-		streambuf_type debug{};
-		streambuf_type info{};
-		streambuf_type notice{};
-		streambuf_type warning{};
-		streambuf_type error{};
-		streambuf_type critical{};
-	} _streambufs;
+private:
+	static constexpr Char _prefix[] = {Chars..., 0};
 
-	mutable lib::ostream _debug{&_streambufs.debug};
-	mutable lib::ostream _info{&_streambufs.info};
-	mutable lib::ostream _notice{&_streambufs.notice};
-	mutable lib::ostream _warning{&_streambufs.warning};
-	mutable lib::ostream _error{&_streambufs.error};
-	mutable lib::ostream _critical{&_streambufs.critical};
+	lib::LogLevel _log_level;
 };
 
 template<class Char, Char ...Prefix> StaticLogger(const lib::basic_static_string<Char, Prefix...>&, LogLevel) -> StaticLogger<Char, Prefix...>;
@@ -78,3 +63,10 @@ template<class Char, Char ...Prefix> StaticLogger(const lib::basic_static_string
 #define LOG_WARN local_logger.warning()
 #define LOG_ERROR local_logger.error()
 #define LOG_CRIT local_logger.critical()
+
+#define BLOG_DEBUG(format, ...) local_logger.binary<::lib::LogLevel::DEBUG>(format ## _ss __VA_OPT__(,) __VA_ARGS__)
+#define BLOG_INFO(format, ...) local_logger.binary<::lib::LogLevel::INFO>(format ## _ss __VA_OPT__(,) __VA_ARGS__)
+#define BLOG_NOTICE(format, ...) local_logger.binary<::lib::LogLevel::NOTICE>(format ## _ss __VA_OPT__(,) __VA_ARGS__)
+#define BLOG_WARN(format, ...) local_logger.binary<::lib::LogLevel::WARNING>(format ## _ss __VA_OPT__(,) __VA_ARGS__)
+#define BLOG_ERROR(format, ...) local_logger.binary<::lib::LogLevel::ERROR>(format ## _ss __VA_OPT__(,) __VA_ARGS__)
+#define BLOG_CRIT(format, ...) local_logger.binary<::lib::LogLevel::CRITICAL>(format ## _ss __VA_OPT__(,) __VA_ARGS__)
@@ -0,0 +1,162 @@
+#include <log/async.hpp>
+
+#include <atomic.hpp>
+#include <ext/ring.hpp>
+
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/irq.hpp>
+#include <log/binary.hpp>
+#include <logger.hpp>
+#include <sched.hpp>
+#include <x86/percpu.hpp>
+
+#include "config.h"
+#include "lines.hpp"
+
+using log::Record;
+
+namespace {
+
+
+/// Number of records in ring of each CPU.
+constexpr size_t RING_SIZE = 32;
+
+
+/// Number of attempts to take drain lock in \ref flush.
+constexpr uint32_t FLUSH_LOCK_ATTEMPTS = 1000000;
+
+
+struct CpuLog {
+	lib::MpscRing<Record, RING_SIZE> ring{};
+
+	/// Number of records dropped since the last drain.
+	lib::atomic<uint32_t> dropped{0};
+};
+
+
+CpuLog cpu_logs[MAX_CPUS];
+
+lib::atomic<bool> active{false};
+
+/// Only one consumer may take records from rings at a time.
+lib::atomic<bool> draining{false};
+
+/// \brief Drain task has work to do.
+///
+/// Drain task clears the flag before it drains rings and sleeps while it's
+/// cleared, so a record pushed during drain isn't left in the ring.
+lib::atomic<bool> wakeup{false};
+
+sched::Task* drain_task = nullptr;
+
+
+LOCAL_LOGGER("log", lib::LogLevel::WARNING);
+
+
+void drain_rings()
+{
+	for (uint32_t cpu = 0; cpu < MAX_CPUS; ++cpu) {
+		auto& cpu_log = cpu_logs[cpu];
+		Record record;
+		while (cpu_log.ring.try_pop(record)) {
+			log::write_to_sinks(record);
+		}
+		if (const uint32_t dropped = cpu_log.dropped.exchange(0)) {
+			LOG_WARN << dropped << " records of CPU #" << cpu
+				<< " are dropped" << lib::endl;
+		}
+	}
+	log::binary::drain();
+}
+
+
+bool try_lock_draining()
+{
+	bool expected = false;
+	return draining.compare_exchange_strong(expected, true);
+}
+
+
+[[noreturn]]
+void drain_routine(void*)
+{
+	while (true) {
+		wakeup.store(false);
+		if (try_lock_draining()) {
+			drain_rings();
+			draining.store(false);
+		}
+		wakeup.wait(false);
+	}
+}
+
+
+} // namespace
+
+
+bool log::async::is_active()
+{
+	return active.load(lib::memory_order_relaxed);
+}
+
+
+void log::async::submit(const Record& record)
+{
+	auto& cpu_log = cpu_logs[x86::this_cpu()->index];
+	if (!cpu_log.ring.try_push(record)) {
+		cpu_log.dropped.fetch_add(1, lib::memory_order_relaxed);
+		return;
+	}
+	wake_up(cpu_log.ring.size(), cpu_log.ring.capacity());
+}
+
+
+void log::async::wake_up(size_t queued, size_t capacity)
+{
+	// Drain task is woken when ring becomes non-empty; the second wakeup at
+	// half of capacity covers the case when the first one is missed
+	// because drain task was passing the ring at that moment.
+	if (queued != 1 && queued != capacity / 2) {
+		return;
+	}
+	// Records of drain task itself, e.g. of its switches, wait for the
+	// next wakeup; otherwise it would wake itself up forever.
+	if (sched::current() == drain_task && !irq::in_interrupt()) {
+		return;
+	}
+	if (!wakeup.exchange(true)) {
+		wakeup.notify_one();
+	}
+}
+
+
+void log::async::start()
+{
+	if constexpr (ASYNC_LOG) {
+		drain_task = sched::create_task(drain_routine, nullptr, "klogd");
+		drain_task->priority(sched::Priority::low);
+		add_panic_notifier(flush);
+		active.store(true);
+	}
+}
+
+
+void log::async::flush()
+{
+	if (!active.exchange(false)) {
+		return;
+	}
+
+	// Drain task may be stopped forever in the middle of drain, e.g. by
+	// panic on its CPU, so the lock is taken by force at the end.
+	for (uint32_t attempt = 0; attempt < FLUSH_LOCK_ATTEMPTS; ++attempt) {
+		if (try_lock_draining()) {
+			break;
+		}
+		x86::cpu_relax();
+	}
+	drain_rings();
+
+	draining.store(false);
+	log::flush_current_lines();
+}
@@ -0,0 +1,110 @@
+#include <log/binary.hpp>
+
+#include <atomic.hpp>
+#include <cstring.hpp>
+#include <ext/ring.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <log/async.hpp>
+#include <log/sink.hpp>
+#include <logger.hpp>
+#include <x86/percpu.hpp>
+
+#include "config.h"
+
+using log::binary::Event;
+
+namespace {
+
+
+/// Number of events in ring of each CPU.
+constexpr size_t RING_SIZE = 64;
+
+
+struct CpuEvents {
+	lib::MpscRing<Event, RING_SIZE> ring{};
+
+	/// Number of events dropped since the last drain.
+	lib::atomic<uint32_t> dropped{0};
+};
+
+
+CpuEvents cpu_events[MAX_CPUS];
+
+
+LOCAL_LOGGER("binlog", lib::LogLevel::WARNING);
+
+
+/// Maximal size of frame.
+constexpr size_t FRAME_SIZE = sizeof(log::binary::FRAME_MAGIC)
+	+ sizeof(Event::cpu) + sizeof(Event::words) + sizeof(Event::format)
+	+ sizeof(Event::tsc) + sizeof(Event::args);
+
+
+char* put_bytes(char* out, const void* data, size_t size)
+{
+	memcpy(out, data, size);
+	return out + size;
+}
+
+
+/// \brief Write event to serial port.
+///
+/// Frame is composed in a buffer and written at once under lock of sinks,
+/// so text records of other CPUs and interrupt handlers can't split it.
+void write_frame(const Event& event)
+{
+	char frame[FRAME_SIZE];
+	char* end = put_bytes(frame, log::binary::FRAME_MAGIC,
+		sizeof(log::binary::FRAME_MAGIC));
+	end = put_bytes(end, &event.cpu, sizeof(event.cpu));
+	end = put_bytes(end, &event.words, sizeof(event.words));
+	end = put_bytes(end, &event.format, sizeof(event.format));
+	end = put_bytes(end, &event.tsc, sizeof(event.tsc));
+	end = put_bytes(end, event.args, event.words * sizeof(event.args[0]));
+	log::write_raw_to_serial(frame, end - frame);
+}
+
+
+} // namespace
+
+
+void log::binary::submit(Event& event)
+{
+	event.tsc = x86::read_tsc();
+	// Per-CPU data is available only after the boot CPU is registered.
+	event.cpu = x86::online_cpus()
+		? static_cast<uint8_t>(x86::this_cpu()->index) : 0;
+
+	if (!async::is_active()) {
+		write_frame(event);
+		return;
+	}
+
+	auto& events = cpu_events[event.cpu];
+	if (!events.ring.try_push(event)) {
+		events.dropped.fetch_add(1, lib::memory_order_relaxed);
+		return;
+	}
+	async::wake_up(events.ring.size(), events.ring.capacity());
+}
+
+
+void log::binary::drain()
+{
+	for (uint32_t cpu = 0; cpu < MAX_CPUS; ++cpu) {
+		auto& events = cpu_events[cpu];
+		Event event;
+		while (events.ring.try_pop(event)) {
+			write_frame(event);
+		}
+		if (const uint32_t dropped = events.dropped.exchange(0)) {
+			LOG_WARN << dropped << " events of CPU #" << cpu
+				<< " are dropped" << lib::endl;
+		}
+	}
+}
+
+
+static_assert(log::binary::format_words<'%', 'u', ' ', '%', '%', ' ', '%',
+	'l', 'l', 'x'>() == 3);
@@ -1 +0,0 @@
-#include "log/delegating_log_buf.hpp"
@@ -0,0 +1,126 @@
+#include <log/dmesg.hpp>
+
+#include <cstdint.hpp>
+#include <mutex.hpp>
+#include <ostream.hpp>
+
+#include <bolgenos-ng/error.h>
+#include <log/async.hpp>
+#include <log/serial_console.hpp>
+#include <log/sink.hpp>
+#include <threading/spinlock.hpp>
+
+#include "config.h"
+
+namespace {
+
+
+constexpr size_t BUFFER_SIZE = DMESG_SIZE;
+
+/// Size of chunks the buffer is dumped by. The lock isn't held while the chunk
+/// is written to the stream.
+constexpr size_t DUMP_CHUNK_SIZE = 128;
+
+
+thr::IrqSpinLock lock{"dmesg"};
+
+char buffer[BUFFER_SIZE];
+
+/// Number of characters written since boot. Text at positions
+/// [head - BUFFER_SIZE, head) is still in the buffer.
+uint32_t head = 0;
+
+
+uint32_t oldest_position()
+{
+	return head > BUFFER_SIZE ? head - BUFFER_SIZE : 0;
+}
+
+
+/// \brief Copy text starting at the position.
+///
+/// If the text at the position is already overwritten, the position is moved
+/// to the oldest character in the buffer. Must be called with lock held
+/// unless the kernel is panicking.
+size_t copy_from(uint32_t& position, char* out, size_t size)
+{
+	if (position < oldest_position()) {
+		position = oldest_position();
+	}
+	size_t copied = 0;
+	while (copied < size && position != head) {
+		out[copied++] = buffer[position % BUFFER_SIZE];
+		++position;
+	}
+	return copied;
+}
+
+
+void dump_to_serial_console()
+{
+	// Records submitted to asynchronous log must get into the buffer
+	// before it's dumped.
+	log::async::flush();
+
+	// The lock isn't taken: on panic it may be held forever.
+	uint32_t position = oldest_position();
+	char chunk[DUMP_CHUNK_SIZE];
+	auto& out = log::serial_console();
+	out << "---- dmesg ----" << lib::endl;
+	while (const size_t length = copy_from(position, chunk, sizeof(chunk))) {
+		out.write(chunk, length);
+	}
+	out << "---- end of dmesg ----" << lib::endl;
+}
+
+
+} // namespace
+
+
+void log::dmesg::write(const Record& record)
+{
+	lib::lock_guard guard{lock};
+	for (size_t i = 0; i < record.length; ++i) {
+		buffer[head % BUFFER_SIZE] = record.text[i];
+		++head;
+	}
+}
+
+
+size_t log::dmesg::read(char* out, size_t size)
+{
+	lib::lock_guard guard{lock};
+	uint32_t position = head > size ? head - size : 0;
+	return copy_from(position, out, size);
+}
+
+
+void log::dmesg::dump(lib::ostream& out)
+{
+	uint32_t position;
+	{
+		lib::lock_guard guard{lock};
+		position = oldest_position();
+	}
+
+	char chunk[DUMP_CHUNK_SIZE];
+	while (true) {
+		size_t length;
+		{
+			lib::lock_guard guard{lock};
+			length = copy_from(position, chunk, sizeof(chunk));
+		}
+		if (length == 0) {
+			break;
+		}
+		out.write(chunk, length);
+	}
+}
+
+
+void log::dmesg::dump_on_panic()
+{
+	if constexpr (DMESG_ON_PANIC) {
+		add_panic_notifier(dump_to_serial_console);
+	}
+}
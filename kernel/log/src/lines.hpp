@@ -0,0 +1,12 @@
+#pragma once
+
+namespace log {
+
+
+/// \brief Write unfinished lines of the current CPU.
+///
+/// Function is used on panic.
+void flush_current_lines();
+
+
+}
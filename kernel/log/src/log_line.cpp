@@ -0,0 +1,126 @@
+#include <log/log_channel.hpp>
+
+#include <bolgenos-ng/irq.hpp>
+#include <log/async.hpp>
+#include <log/simple_stream_buf.hpp>
+#include <log/sink.hpp>
+#include <x86/percpu.hpp>
+
+#include "config.h"
+#include "lines.hpp"
+
+namespace {
+
+
+/// \brief Streambuf that collects a line into record.
+///
+/// Prefix is written before the first character of each record. Finished
+/// records are written to sinks or, if asynchronous logging is active, put
+/// to ring of the current CPU.
+class LineBuf: public SimpleStreamBuf<lib::streambuf> {
+public:
+	void begin(lib::LogLevel level, const char* prefix) {
+		if (!_record.length) {
+			_level = level;
+			_prefix = prefix;
+		}
+	}
+
+	void flush() {
+		if (_record.length) {
+			commit();
+		}
+	}
+
+protected:
+	int overflow(int c) override {
+		if (!_record.length) {
+			_record.level = _level;
+			for (const char* p = _prefix; *p; ++p) {
+				append(*p);
+			}
+		}
+		append(static_cast<char>(c));
+		if (c == '\n') {
+			commit();
+		}
+		return c;
+	}
+
+private:
+	void append(char c) {
+		if (_record.length == log::RECORD_SIZE) {
+			commit();
+		}
+		_record.text[_record.length++] = c;
+	}
+
+	void commit() {
+		if (log::async::is_active()) {
+			log::async::submit(_record);
+		} else {
+			log::write_to_sinks(_record);
+		}
+		_record.length = 0;
+	}
+
+	log::Record _record{};
+	lib::LogLevel _level{lib::LogLevel::INFO};
+	const char* _prefix{""};
+};
+
+
+/// Line that is being written in some context.
+struct Context {
+	LineBuf buf{};
+	lib::ostream stream{&buf};
+};
+
+
+/// \brief Contexts of log lines.
+///
+/// Every CPU has separate contexts for tasks and for interrupt handlers, so
+/// lines of different contexts aren't mixed.
+Context (&contexts())[MAX_CPUS][2]
+{
+	static Context instance[MAX_CPUS][2];
+	return instance;
+}
+
+
+/// Contexts of the current CPU.
+Context (&cpu_contexts())[2]
+{
+	// Per-CPU data is available only after the boot CPU is registered.
+	if (!x86::online_cpus()) {
+		return contexts()[0];
+	}
+	return contexts()[x86::this_cpu()->index];
+}
+
+
+Context& current_context()
+{
+	return cpu_contexts()[x86::online_cpus() && irq::in_interrupt() ? 1 : 0];
+}
+
+
+} // namespace
+
+
+lib::ostream& log::begin_line(lib::LogLevel level, const char* prefix)
+{
+	auto& context = current_context();
+	context.buf.begin(level, prefix);
+	context.stream.setf(lib::ostream::dec, lib::ostream::basefield);
+	context.stream.width(0);
+	return context.stream;
+}
+
+
+void log::flush_current_lines()
+{
+	for (auto& context: cpu_contexts()) {
+		context.buf.flush();
+	}
+}
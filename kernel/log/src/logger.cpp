@@ -1 +1,8 @@
 #include <logger.hpp>
+
+
+lib::ostream& log::null_stream()
+{
+	static lib::ostream stream;
+	return stream;
+}
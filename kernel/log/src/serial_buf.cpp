@@ -1,18 +1,22 @@
 #include "log/serial_buf.hpp"
 
-#include <utility.hpp>
+#include <serial/uart.hpp>
 
-SerialBuf::SerialBuf(serial::SerialPort port)
-	: _port{lib::move(port)}
+SerialBuf::SerialBuf()
+	: SerialBuf{serial::Uart::com1()}
+{}
+
+SerialBuf::SerialBuf(serial::Uart& uart)
+	: _uart{uart}
 {}
 
 int SerialBuf::overflow(int c)
 {
 	if (c == '\n') {
-		_port.write('\n');
-		_port.write('\r');
+		_uart.write('\n');
+		_uart.write('\r');
 	} else {
-		_port.write(c);
+		_uart.write(c);
 	}
 	return c;
 }
@@ -0,0 +1,212 @@
+#include <log/sink.hpp>
+
+#include <atomic.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/vga_console.hpp>
+#include <log/dmesg.hpp>
+#include <log/serial_buf.hpp>
+#include <log/vga_buf.hpp>
+#include <mutex.hpp>
+#include <serial/uart.hpp>
+#include <threading/spinlock.hpp>
+#include <x86/percpu.hpp>
+
+namespace {
+
+
+/// Port of QEMU and Bochs debug console.
+constexpr uint16_t DEBUGCON_PORT = 0xe9;
+
+
+constexpr vga_console::color_t color(lib::LogLevel level) {
+	switch (level)
+	{
+	case lib::LogLevel::CRITICAL: return vga_console::red;
+	case lib::LogLevel::ERROR: return vga_console::bright_red;
+	case lib::LogLevel::WARNING: return vga_console::yellow;
+	case lib::LogLevel::NOTICE: return vga_console::green;
+	case lib::LogLevel::INFO: return vga_console::bright_green;
+	case lib::LogLevel::DEBUG: return vga_console::bright_green;
+	default: panic("Unknown log level");
+	}
+}
+
+
+class VgaSink: public log::Sink {
+public:
+	using Sink::Sink;
+
+	void write(const log::Record& record) override {
+		const auto saved_color = vga_console::get_fg();
+		vga_console::set_fg(color(record.level));
+		_buf.sputn(record.text, record.length);
+		vga_console::set_fg(saved_color);
+		vga_console::flush();
+	}
+
+private:
+	VgaBuf _buf{};
+};
+
+
+class SerialSink: public log::Sink {
+public:
+	using Sink::Sink;
+
+	void write(const log::Record& record) override {
+		_buf.sputn(record.text, record.length);
+	}
+
+private:
+	SerialBuf _buf{};
+};
+
+
+/// \brief Sink of QEMU debug console.
+///
+/// The port has no status register: every character is written by single
+/// `outb`, so the sink is cheap enough for early boot and hot paths.
+class DebugconSink: public log::Sink {
+public:
+	using Sink::Sink;
+
+	void write(const log::Record& record) override {
+		for (size_t i = 0; i < record.length; ++i) {
+			outb(DEBUGCON_PORT, static_cast<uint8_t>(record.text[i]));
+		}
+	}
+};
+
+
+class DmesgSink: public log::Sink {
+public:
+	using Sink::Sink;
+
+	void write(const log::Record& record) override {
+		log::dmesg::write(record);
+	}
+};
+
+
+struct Registry {
+	Registry() {
+		add(vga, LOG_VGA_LEVEL);
+		add(serial, LOG_SERIAL_LEVEL);
+		add(debugcon, LOG_DEBUGCON_LEVEL);
+		add(dmesg, LOG_DMESG_LEVEL);
+	}
+
+	Registry(const Registry&) = delete;
+	Registry& operator=(const Registry&) = delete;
+
+	/// Add sink if it isn't disabled by configuration.
+	void add(log::Sink& sink, int level) {
+		if (level >= 0) {
+			sinks[count.load()] = &sink;
+			count.fetch_add(1);
+		}
+	}
+
+	VgaSink vga{lib::LogLevel{LOG_VGA_LEVEL}};
+	SerialSink serial{lib::LogLevel{LOG_SERIAL_LEVEL}};
+	DebugconSink debugcon{lib::LogLevel{LOG_DEBUGCON_LEVEL}};
+	DmesgSink dmesg{lib::LogLevel{LOG_DMESG_LEVEL}};
+	log::Sink* sinks[log::MAX_SINKS]{};
+	lib::atomic<size_t> count{0};
+};
+
+
+Registry& registry()
+{
+	static Registry instance;
+	return instance;
+}
+
+
+/// \brief Lock of sinks.
+///
+/// Consoles are plain state machines, so records and binary frames are
+/// written by one CPU at a time and interrupt handlers can't break into
+/// the middle of them.
+thr::IrqSpinLock sinks_lock{"log_sinks"};
+
+
+constexpr uint32_t NO_OWNER = ~static_cast<uint32_t>(0);
+
+/// CPU that holds \ref sinks_lock.
+lib::atomic<uint32_t> sinks_owner{NO_OWNER};
+
+
+uint32_t current_cpu()
+{
+	// Per-CPU data is available only after the boot CPU is registered.
+	return x86::online_cpus() ? x86::this_cpu()->index : 0;
+}
+
+
+/// Call function under \ref sinks_lock unless this CPU already holds it.
+template<typename F>
+void with_sinks_lock(F&& f)
+{
+	const uint32_t cpu = current_cpu();
+	if (sinks_owner.load(lib::memory_order_relaxed) == cpu) {
+		// Output is written by sink itself, e.g. by panic in the middle
+		// of write; waiting for the lock would hang the CPU.
+		f();
+		return;
+	}
+
+	lib::lock_guard guard{sinks_lock};
+	sinks_owner.store(cpu, lib::memory_order_relaxed);
+	f();
+	sinks_owner.store(NO_OWNER, lib::memory_order_relaxed);
+}
+
+
+void write_unlocked(const log::Record& record)
+{
+	auto& sinks = registry();
+	const size_t count = sinks.count.load();
+	for (size_t i = 0; i < count; ++i) {
+		if (sinks.sinks[i]->accepts(record.level)) {
+			sinks.sinks[i]->write(record);
+		}
+	}
+}
+
+
+} // namespace
+
+
+void log::add_sink(Sink* sink)
+{
+	auto& sinks = registry();
+	const size_t index = sinks.count.load();
+	if (index == MAX_SINKS) {
+		panic("too many log sinks");
+	}
+	sinks.sinks[index] = sink;
+	sinks.count.store(index + 1);
+}
+
+
+void log::write_to_sinks(const Record& record)
+{
+	with_sinks_lock([&]() {
+		write_unlocked(record);
+	});
+}
+
+
+void log::write_raw_to_serial(const void* data, size_t size)
+{
+	with_sinks_lock([&]() {
+		auto& uart = serial::Uart::com1();
+		const auto* bytes = static_cast<const char*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			uart.write(bytes[i]);
+		}
+	});
+}
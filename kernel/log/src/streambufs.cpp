@@ -1,19 +1,24 @@
 #include "streambufs.hpp"
 
+#include <ostream.hpp>
 #include <streambuf.hpp>
+#include <log/serial_console.hpp>
 #include <log/vga_buf.hpp>
 #include <log/serial_buf.hpp>
 
 namespace {
 
 VgaBuf sbuf_vga_console_impl{};
-SerialBuf sbuf_serial_console_impl{[](){
-	serial::SerialPort com_port(serial::ComPort::COM1);
-	com_port.configure();
-	return com_port;
-}()};
+SerialBuf sbuf_serial_console_impl{};
+
+lib::ostream serial_console_stream{&sbuf_serial_console_impl};
 
 }
 
 lib::streambuf& log::sbuf_vga_console{sbuf_vga_console_impl};
 lib::streambuf& log::sbuf_serial_console{sbuf_serial_console_impl};
+
+lib::ostream& log::serial_console()
+{
+	return serial_console_stream;
+}
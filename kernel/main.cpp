@@ -1,18 +1,27 @@
 
 #include <cxxabi.h>
 #include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/fb_console.hpp>
 #include <bolgenos-ng/interrupt_controller.hpp>
 #include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/irq_trace.hpp>
+#include <bolgenos-ng/lapic_timer.hpp>
 #include <logger.hpp>
+#include <log/async.hpp>
+#include <log/dmesg.hpp>
 #include <bolgenos-ng/memory.hpp>
 #include <bolgenos-ng/multiboot_info.hpp>
 #include <bolgenos-ng/ost.hpp>
 #include <bolgenos-ng/pit.hpp>
+#include <bolgenos-ng/tick.hpp>
 #include <bolgenos-ng/time.hpp>
 #include <ps2/controller.hpp>
+#include <serial/uart.hpp>
 #include <bolgenos-ng/vga_console.hpp>
 #include <x86/cpu.hpp>
+#include <x86/smp.hpp>
 #include <sched.hpp>
+#include <sched/work_queue.hpp>
 
 #include "config.h"
 
@@ -42,9 +51,45 @@ void test_task(void* number_ptr) {
 	}
 }
 
+/// \brief Switch console to framebuffer set up by bootloader.
+///
+/// Only direct color framebuffer below 4 GiB with 15, 16, 24 or 32 bits per
+/// pixel is supported. If bootloader left VGA text mode, it's used as usual.
+/// If bootloader set up any other graphics mode, nothing can be shown on
+/// screen: the kernel can't switch back to text mode, so only serial and
+/// debugcon logs remain.
+///
+/// \return false if console output isn't visible on screen.
+bool init_framebuffer_console() {
+	const auto* fb = multiboot::boot_info->framebuffer();
+	if (!fb || fb->type == multiboot::FRAMEBUFFER_EGA_TEXT) {
+		return true;
+	}
+	if (fb->type != multiboot::FRAMEBUFFER_RGB
+			|| fb->address + fb->height * fb->pitch > 0x100000000ull) {
+		return false;
+	}
+	return fb_console::init({
+		static_cast<uint32_t>(fb->address),
+		fb->pitch,
+		fb->width,
+		fb->height,
+		fb->bpp,
+		fb->red_position,
+		fb->red_size,
+		fb->green_position,
+		fb->green_size,
+		fb->blue_position,
+		fb->blue_size,
+	});
+}
+
 [[noreturn]]
 void multithreaded_init_stage(void*) {
 	LOG_NOTICE << "Continue initialization in multithreaded env" << endl;
+	sched::WorkQueue::system().start();
+	log::async::start();
+	x86::smp::init();
 	LOG_NOTICE << "Configuring serial port" << endl;
 
 	LOG_NOTICE << "Kernel initialization routine has been finished!" << endl;
@@ -55,8 +100,9 @@ void multithreaded_init_stage(void*) {
 		sleep_ms(sleep_interval/tasks_count);
 	}
 
+	sched::current()->priority(sched::Priority::idle);
 	do {
-		x86::halt_cpu();
+		tick::idle();
 		sched::yield();
 	} while(true);
 }
@@ -74,6 +120,10 @@ extern "C" [[maybe_unused]] [[noreturn]] void kernel_main() {
 
 	call_global_ctors();
 
+	bool console_visible = true;
+	if constexpr (FRAMEBUFFER_CONSOLE) {
+		console_visible = init_framebuffer_console();
+	}
 	vga_console::clear_screen();
 
 	LOG_WARN
@@ -87,8 +137,15 @@ extern "C" [[maybe_unused]] [[noreturn]] void kernel_main() {
 
 	LOG_NOTICE << "Starting bolgenos-ng-" << BOLGENOS_NG_VERSION
 		<< endl;
+	if (!console_visible) {
+		const auto* fb = multiboot::boot_info->framebuffer();
+		LOG_WARN.format("unsupported framebuffer: type {}, {} bpp; "
+			"console isn't shown on screen",
+			unsigned{fb->type}, unsigned{fb->bpp});
+	}
 
 	cpu.load_kernel_segments();
+	irq::trace::start();
 	cpu.load_interrupts_table();
 	memory::init(); // Allow allocation
 
@@ -96,10 +153,16 @@ extern "C" [[maybe_unused]] [[noreturn]] void kernel_main() {
 
 	auto interrupt_controller = devices::InterruptController::instance();
 	interrupt_controller->initialize_controller();
+	serial::Uart::com1().enable_interrupts(
+		interrupt_controller->min_irq_vector()
+		+ serial::isa_line(serial::ComPort::COM1));
+	log::dmesg::dump_on_panic();
 
 
 
 	pit::init();
+	lapic_timer::init();
+	tick::init();
 
 	irq::enable();
 
@@ -29,10 +29,16 @@ void memory::allocators::BuddyAllocator::put(pblk_t blk) {
 		panic(__func__);
 	}
 
+	stats_lock_.write([&]() {
+		++stats_.deallocations;
+		stats_.free_pages += blk.size;
+	});
 
-	++stats.deallocations;
+	release(blk);
+}
 
 
+void memory::allocators::BuddyAllocator::release(pblk_t blk) {
 	while(blk.size) {
 		size_t block_order = compute_order(blk);
 
@@ -62,7 +68,9 @@ memory::allocators::pblk_t memory::allocators::BuddyAllocator::get(size_t pages)
 	pblk_t blk = {nullptr, 0};
 	size_t order = 0;
 
-	++stats.allocations;
+	stats_lock_.write([&]() {
+		++stats_.allocations;
+	});
 
 	while (pages > (size_t(1) << order)) {
 		++order;
@@ -89,9 +97,13 @@ memory::allocators::pblk_t memory::allocators::BuddyAllocator::get(size_t pages)
 	pblk_t extra_memory = {blk.ptr + pages, (1 << order) - pages};
 
 	if (extra_memory.size) {
-		put(extra_memory);
+		release(extra_memory);
 	}
 
+	stats_lock_.write([&]() {
+		stats_.free_pages -= pages;
+	});
+
 	return blk;
 }
 
@@ -101,6 +113,12 @@ const memory::MemoryRegion *memory::allocators::BuddyAllocator::region() const {
 }
 
 
+memory::allocators::BuddyAllocator::stats_type
+memory::allocators::BuddyAllocator::stats() const {
+	return stats_lock_.read([this]() { return stats_; });
+}
+
+
 size_t memory::allocators::BuddyAllocator::compute_order(const pblk_t &blk) {
 	size_t order = 0;
 
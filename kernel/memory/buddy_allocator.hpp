@@ -4,6 +4,7 @@
 #include <type_traits.hpp>
 
 #include <bolgenos-ng/page.hpp>
+#include <threading/seqlock.hpp>
 
 #include "free_list.hpp"
 #include "memory_region.hpp"
@@ -80,11 +81,11 @@ public:
 
 		/// Total number of deallocations.
 		size_t deallocations = 0;
-	};
 
 
-	/// Statistic of allocator.
-	stats_type stats = {};
+		/// Number of free pages.
+		size_t free_pages = 0;
+	};
 
 
 	/// Constructor.
@@ -132,6 +133,13 @@ public:
 	const memory::MemoryRegion *region() const;
 
 
+	/// \brief Get statistics of allocator.
+	///
+	/// The function returns consistent snapshot of statistics without
+	/// locking, so it may be called from any context.
+	stats_type stats() const;
+
+
 private:
 	/// Max order of freelist in buddy system.
 	static constexpr size_t MAX_ORDER = config::memory::BUDDY_ALLOCATOR_MAX_ORDER;
@@ -145,12 +153,26 @@ private:
 	/// \return order of the free list allocator.
 	size_t compute_order(const pblk_t &blk);
 
+	/// \brief Put block to free lists.
+	///
+	/// The function does the work of \ref put without updating
+	/// statistics.
+	void release(pblk_t blk);
+
 	/// Set of free list allocators.
 	FreeList free_list_[MAX_ORDER + 1];
 
 
 	/// Region of memory that are covered by this buddy system.
 	const memory::MemoryRegion *region_ = nullptr;
+
+
+	/// Statistic of allocator.
+	stats_type stats_ = {};
+
+
+	/// Lock that publishes \ref stats_ to readers.
+	thr::SeqLock stats_lock_{"buddy_stats"};
 }; // class BuddyAllocator
 
 
@@ -37,6 +37,26 @@ void *alloc_pages(size_t n);
 void free_pages(void *addr);
 
 
+/// \brief Statistics of page allocator.
+struct page_stats_t {
+	/// Total number of page block allocations.
+	size_t allocations;
+
+	/// Total number of page block deallocations.
+	size_t deallocations;
+
+	/// Number of free pages.
+	size_t free_pages;
+};
+
+
+/// \brief Get statistics of page allocator.
+///
+/// The function reads statistics without locking, so it may be called
+/// from any context including interrupt handlers.
+page_stats_t page_stats();
+
+
 /// \brief Allocate kernel memory.
 ///
 /// The function allocates memory from kernel mallocator.
@@ -1,5 +1,6 @@
 #include "mallocator.hpp"
 
+#include <mutex.hpp>
 #include <new.hpp>
 #include <bolgenos-ng/error.h>
 
@@ -50,13 +51,16 @@ void *memory::allocators::Mallocator::allocate(size_t bytes) {
 		}
 	}
 
-	while (slab_idx != chain_length_) {
-		void *memory = nullptr;
-		memory = chain_[slab_idx].allocate();
-		if (memory) {
-			return memory;
+	{
+		lib::lock_guard guard{lock_};
+		while (slab_idx != chain_length_) {
+			void *memory = nullptr;
+			memory = chain_[slab_idx].allocate();
+			if (memory) {
+				return memory;
+			}
+			++slab_idx;
 		}
-		++slab_idx;
 	}
 
 	size_t pages = align_up<PAGE_SIZE>(bytes) / PAGE_SIZE;
@@ -67,13 +71,16 @@ void *memory::allocators::Mallocator::allocate(size_t bytes) {
 void memory::allocators::Mallocator::deallocate(void *memory) {
 	assert_initialized();
 
-	size_t chain_idx = 0;
-	while (chain_idx != chain_length_) {
-		if (chain_[chain_idx].owns(memory)) {
-			chain_[chain_idx].deallocate(memory);
-			return;
+	{
+		lib::lock_guard guard{lock_};
+		size_t chain_idx = 0;
+		while (chain_idx != chain_length_) {
+			if (chain_[chain_idx].owns(memory)) {
+				chain_[chain_idx].deallocate(memory);
+				return;
+			}
+			++chain_idx;
 		}
-		++chain_idx;
 	}
 	fallback_->deallocate(memory);
 }
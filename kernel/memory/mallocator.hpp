@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bolgenos-ng/slab.hpp>
+#include <threading/spinlock.hpp>
 
 #include "page_allocator.hpp"
 
@@ -11,6 +12,12 @@ namespace memory {
 namespace allocators {
 
 
+/// \brief Allocator of small objects.
+///
+/// Chain of slabs is protected by spinlock, so the allocator can be used on
+/// several CPUs and from interrupt handlers. Large blocks are taken from
+/// the fallback page allocator outside of the spinlock; it has its own
+/// spinlock.
 class Mallocator {
 public:
 	Mallocator() = default;
@@ -30,6 +37,7 @@ private:
 	PageAllocator *fallback_ = nullptr;
 	SlabAllocator internal_allocator_ = {};
 	bool _initialized{false};
+	thr::IrqSpinLock lock_{"kmalloc"};
 };
 
 
@@ -72,6 +72,12 @@ void memory::free_pages(void *address) {
 }
 
 
+memory::page_stats_t memory::page_stats() {
+	const auto stats = highmem_buddy_allocator.stats();
+	return {stats.allocations, stats.deallocations, stats.free_pages};
+}
+
+
 void memory::init() {
 	detect_memory_regions();
 	initilize_highmem_allocators();
@@ -1,6 +1,6 @@
 #include "page_allocator.hpp"
 
-#include <threading/lock.hpp>
+#include <mutex.hpp>
 
 #include "buddy_allocator.hpp"
 #include "memory_region.hpp"
@@ -35,7 +35,7 @@ void memory::allocators::PageAllocator::initialize(BuddyAllocator *primary,
 }
 
 void *memory::allocators::PageAllocator::allocate(size_t pages) {
-	thr::RecursiveIrqGuard guard;
+	lib::lock_guard guard{lock_};
 
 	if (!pages) {
 		// zero-size allocation should return valid address!
@@ -55,7 +55,7 @@ void *memory::allocators::PageAllocator::allocate(size_t pages) {
 }
 
 void memory::allocators::PageAllocator::deallocate(void *memory) {
-	thr::RecursiveIrqGuard guard;
+	lib::lock_guard guard{lock_};
 
 	if ((memory == nullptr) || (memory == zero_size_page)) {
 		return;
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <bitarray.hpp>
+
+#include <threading/spinlock.hpp>
+
 #include "memory_region.hpp"
 
 
@@ -74,6 +77,14 @@ private:
 
 	/// map for keeping ends of page blocks.
 	util::inplace::BitArray map_ = {};
+
+
+	/// \brief Lock that protects the buddy system and the map.
+	///
+	/// Pages are allocated before scheduling starts on application
+	/// processors, with disabled interrupts and by kmalloc on behalf of
+	/// interrupt handlers, so the lock can't sleep.
+	thr::IrqSpinLock lock_{"page_alloc"};
 };
 
 
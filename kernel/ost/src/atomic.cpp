@@ -0,0 +1,43 @@
+#include <atomic.hpp>
+#include <bolgenos-ng/ost.hpp>
+
+
+TEST(Atomic, bit_operations) {
+	lib::atomic<uint32_t> value{0x0f};
+
+	OST_ASSERT(value.fetch_or(0xf0) == 0x0f);
+	OST_ASSERT(value.fetch_and(0x3c) == 0xff);
+	OST_ASSERT(value.fetch_xor(0x0f) == 0x3c);
+	OST_ASSERT(value.load(lib::memory_order_relaxed) == 0x33);
+}
+
+
+TEST(Atomic, compare_exchange) {
+	lib::atomic<int> value{1};
+
+	int expected = 2;
+	OST_ASSERT(!value.compare_exchange_strong(expected, 3));
+	OST_ASSERT(expected == 1, "observed value isn't returned");
+	OST_ASSERT(value.compare_exchange_strong(expected, 3));
+	OST_ASSERT(value.load() == 3);
+}
+
+
+TEST(Atomic, pointer_arithmetic) {
+	int array[4]{};
+	lib::atomic<int*> ptr{array};
+
+	OST_ASSERT(ptr.fetch_add(2) == array);
+	OST_ASSERT(ptr.load() == array + 2);
+	OST_ASSERT(--ptr == array + 1);
+}
+
+
+TEST(Atomic, flag) {
+	lib::atomic_flag flag;
+
+	OST_ASSERT(!flag.test_and_set());
+	OST_ASSERT(flag.test_and_set());
+	flag.clear();
+	OST_ASSERT(!flag.test());
+}
@@ -0,0 +1,74 @@
+#include <cstring.hpp>
+#include <format.hpp>
+#include <ext/snprintf_stream.hpp>
+#include <bolgenos-ng/ost.hpp>
+
+
+namespace {
+
+
+struct Custom {
+	int value;
+};
+
+
+lib::ostream& operator<<(lib::ostream& out, const Custom& custom)
+{
+	return out << lib::hex << "custom(" << custom.value << ")";
+}
+
+
+} // namespace
+
+
+TEST(Format, format_to) {
+	char buffer[64];
+
+	lib::format_to(buffer, "{} {} {} {}", 0, -42, 3000000000u, "text");
+	OST_ASSERT(strcmp(buffer, "0 -42 3000000000 text") == 0,
+		"got ", buffer);
+
+	lib::format_to(buffer, "{:08x}|{:#x}|{:X}|{:#06x}", 0xbeefu, 255, 0xabcu, 10);
+	OST_ASSERT(strcmp(buffer, "0000beef|0xff|ABC|0x000a") == 0,
+		"got ", buffer);
+
+	lib::format_to(buffer, "[{:>5}][{:<5}][{:*^7}][{:5}]", 12, 12, "ab", "s");
+	OST_ASSERT(strcmp(buffer, "[   12][12   ][**ab***][s    ]") == 0,
+		"got ", buffer);
+
+	lib::format_to(buffer, "{{{}}} {} {:c}{:d}", 'x', true, 'y', 'z');
+	OST_ASSERT(strcmp(buffer, "{x} true y122") == 0, "got ", buffer);
+
+	lib::format_to(buffer, "{:p} {}", reinterpret_cast<const void*>(0x1000),
+		Custom{26});
+	OST_ASSERT(strcmp(buffer, "0x1000 custom(1a)") == 0, "got ", buffer);
+}
+
+
+TEST(Format, stream_width) {
+	char buffer[32];
+	lib::SnprintfStream out{buffer, sizeof(buffer)};
+
+	out << lib::setw(6);
+	lib::format_to(out, "{:x}", 0xabu);
+	out << 1;
+	OST_ASSERT(strcmp(buffer, "ab1") == 0, "got ", buffer);
+	OST_ASSERT(out.width() == 0, "got ", out.width());
+}
+
+
+TEST(Format, truncation) {
+	char buffer[8];
+
+	const size_t length = lib::format_to(buffer, "{}-{}", 123456, 789);
+	OST_ASSERT(length == 7, "got ", length);
+	OST_ASSERT(strcmp(buffer, "123456-") == 0, "got ", buffer);
+
+	OST_ASSERT(lib::format_to(buffer, 0, "{}", 1) == 0);
+}
+
+TEST(Format, logger) {
+	LOCAL_LOGGER("ost", lib::LogLevel::INFO);
+	LOG_INFO.format("format_to: {:#010x} {}", 0xc0ffeeu, "logged");
+	LOG_DEBUG.format("not printed: {}", 1);
+}
@@ -0,0 +1,75 @@
+#include <cstring.hpp>
+#include <ext/snprintf_stream.hpp>
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/ost.hpp>
+
+
+namespace {
+
+
+constexpr size_t BUFFER_SIZE = 64;
+
+
+} // namespace
+
+
+TEST(OStream, integers) {
+	char buffer[BUFFER_SIZE];
+	{
+		lib::SnprintfStream out{buffer, sizeof(buffer)};
+		out << 0 << ' ' << 7 << ' ' << 42 << ' ' << 100 << ' ' << 12345
+			<< ' ' << -9 << ' ' << (-2147483647 - 1);
+		OST_ASSERT(strcmp(buffer, "0 7 42 100 12345 -9 -2147483648") == 0,
+			"got ", buffer);
+	}
+	{
+		lib::SnprintfStream out{buffer, sizeof(buffer)};
+		out << lib::hex << 0u << ' ' << 0xdeadbeefu << ' '
+			<< static_cast<short>(-1);
+		OST_ASSERT(strcmp(buffer, "0 deadbeef ffff") == 0,
+			"got ", buffer);
+	}
+	{
+		lib::SnprintfStream out{buffer, sizeof(buffer)};
+		out << lib::setfill('0') << lib::setw(8) << lib::hex << 0xbeefu
+			<< lib::setfill(' ') << lib::setw(4) << lib::dec << -5
+			<< lib::setw(3) << "ab";
+		OST_ASSERT(strcmp(buffer, "0000beef  -5 ab") == 0,
+			"got ", buffer);
+	}
+	{
+		// Padding that doesn't fit field buffer.
+		lib::SnprintfStream out{buffer, sizeof(buffer)};
+		out << lib::setfill('.') << lib::setw(40) << 1;
+		OST_ASSERT(strlen(buffer) == 40, "got ", buffer);
+		OST_ASSERT(buffer[38] == '.' && buffer[39] == '1', "got ", buffer);
+	}
+}
+
+
+TEST(OStream, benchmark) {
+	LOCAL_LOGGER("ost", lib::LogLevel::INFO);
+	constexpr uint32_t ROUNDS = 1000;
+	char buffer[BUFFER_SIZE];
+
+	uint64_t start = x86::read_tsc();
+	for (uint32_t i = 0; i < ROUNDS; ++i) {
+		lib::SnprintfStream out{buffer, sizeof(buffer)};
+		out << i * 2654435761u;
+	}
+	uint64_t dec_cycles = x86::read_tsc() - start;
+	x86::div64(dec_cycles, ROUNDS);
+
+	start = x86::read_tsc();
+	for (uint32_t i = 0; i < ROUNDS; ++i) {
+		lib::SnprintfStream out{buffer, sizeof(buffer)};
+		out << lib::setfill('0') << lib::setw(8) << lib::hex
+			<< i * 2654435761u;
+	}
+	uint64_t hex_cycles = x86::read_tsc() - start;
+	x86::div64(hex_cycles, ROUNDS);
+
+	LOG_INFO << "ostream: decimal " << static_cast<uint32_t>(dec_cycles)
+		<< " cycles, padded hex " << static_cast<uint32_t>(hex_cycles)
+		<< " cycles" << lib::endl;
+}
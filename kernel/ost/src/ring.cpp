@@ -0,0 +1,46 @@
+#include <ext/ring.hpp>
+#include <bolgenos-ng/ost.hpp>
+
+
+TEST(SpscRing, test) {
+	lib::SpscRing<int, 4> ring;
+	int value = 0;
+
+	OST_ASSERT(ring.empty());
+	OST_ASSERT(!ring.try_pop(value));
+
+	for (int i = 0; i != 4; ++i) {
+		OST_ASSERT(ring.try_push(i));
+	}
+	OST_ASSERT(!ring.try_push(4), "push to full ring");
+	OST_ASSERT(ring.size() == 4);
+
+	// Indexes wrap around the capacity several times.
+	for (int i = 0; i != 20; ++i) {
+		OST_ASSERT(ring.try_pop(value));
+		OST_ASSERT(value == i, "expected ", i, " got ", value);
+		OST_ASSERT(ring.try_push(i + 4));
+	}
+	OST_ASSERT(ring.size() == 4);
+}
+
+
+TEST(MpscRing, test) {
+	lib::MpscRing<int, 4> ring;
+	int value = 0;
+
+	OST_ASSERT(ring.empty());
+	OST_ASSERT(!ring.try_pop(value));
+
+	for (int i = 0; i != 4; ++i) {
+		OST_ASSERT(ring.try_push(i));
+	}
+	OST_ASSERT(!ring.try_push(4), "push to full ring");
+
+	for (int i = 0; i != 20; ++i) {
+		OST_ASSERT(ring.try_pop(value));
+		OST_ASSERT(value == i, "expected ", i, " got ", value);
+		OST_ASSERT(ring.try_push(i + 4));
+	}
+	OST_ASSERT(ring.size() == 4);
+}
@@ -0,0 +1,71 @@
+#include <atomic.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/error.h>
+#include <sched.hpp>
+#include <sched/wait_queue.hpp>
+#include <threading/with_lock.hpp>
+
+namespace {
+
+
+/// \brief Number of wait queues for atomic values.
+///
+/// Addresses are hashed to queues, so different values may share a queue.
+constexpr size_t WAIT_BUCKETS = 16;
+
+sched::WaitQueue wait_buckets[WAIT_BUCKETS];
+
+
+sched::WaitQueue& bucket_of(const volatile void* addr)
+{
+	const auto value = reinterpret_cast<lib::uintptr_t>(addr);
+	return wait_buckets[(value >> 2) % WAIT_BUCKETS];
+}
+
+
+uint32_t read_word(const volatile void* addr, size_t size)
+{
+	switch (size) {
+	case 1:
+		return *static_cast<const volatile uint8_t*>(addr);
+	case 2:
+		return *static_cast<const volatile uint16_t*>(addr);
+	case 4:
+		return *static_cast<const volatile uint32_t*>(addr);
+	default:
+		panic("unsupported size of atomic value");
+	}
+}
+
+
+} // namespace
+
+
+void lib::details::atomic_wait(const volatile void* addr, size_t size,
+	uint32_t old)
+{
+	if (!sched::current()) {
+		// Nobody can change the value but interrupt handlers.
+		x86::cpu_relax();
+		return;
+	}
+
+	thr::with_irq_lock([&]() {
+		if (read_word(addr, size) != old) {
+			return;
+		}
+		bucket_of(addr).wait();
+	});
+}
+
+
+void lib::details::atomic_notify(const volatile void* addr, bool all)
+{
+	thr::with_irq_lock([&]() {
+		// Queue may be shared with other values, so waking up single
+		// task could wake up the wrong one.
+		(void) all;
+		bucket_of(addr).notify_all();
+	});
+}
@@ -6,12 +6,40 @@ namespace sched {
 
 void yield();
 
-Task* create_task(task_routine* routine, void* arg, const char* name = nullptr);
+/// \brief Create new task.
+///
+/// \param routine Function to be run by the task.
+/// \param arg Argument for the routine.
+/// \param name Name of the task.
+/// \param stack_size Size of task stack in bytes. Value 0 means default size
+///	that is defined by TASK_STACK_SIZE config option.
+Task* create_task(task_routine* routine, void* arg, const char* name = nullptr,
+	size_t stack_size = 0);
+
+/// \brief Current task.
+///
+/// \return Currently running task or nullptr if scheduling isn't started.
+Task* current();
+
+/// \brief Sleep.
+///
+/// The function blocks current task till the specified time.
+///
+/// \param deadline_ns Time to wake up at, see \ref time::now_ns.
+void sleep_until(uint64_t deadline_ns);
 
 namespace details {
 
 void init_scheduling(task_routine* main_continuation);
 
+/// \brief Start scheduling on application processor.
+///
+/// The function runs scheduler of the current CPU with an idle task that
+/// keeps it halted while there are no tasks to run. Interrupts must be
+/// enabled.
+[[noreturn]]
+void start_cpu_scheduling();
+
 } // namespace details
 
 } // namespace sched
@@ -18,6 +18,28 @@ class Scheduler;
 
 enum class TaskId: uint32_t {};
 
+/// \brief Priority of task.
+///
+/// Scheduler runs only tasks with the highest priority among runnable ones.
+enum class Priority: uint8_t {
+	idle,
+	low,
+	normal,
+	high,
+};
+
+/// State of task.
+enum class TaskState: uint8_t {
+	/// Task may be scheduled.
+	runnable,
+	/// Task waits in \ref WaitQueue.
+	blocked,
+	/// Task sleeps till specified time.
+	sleeping,
+};
+
+class WaitQueue;
+
 lib::ostream& operator<<(lib::ostream& out, TaskId id);
 
 struct Task: private Loggable("Task") {
@@ -51,14 +73,42 @@ public:
 	[[nodiscard]]
 	void* stack() const { return _stack; }
 
+	[[nodiscard]]
+	size_t stack_size() const;
+
 	[[nodiscard]]
 	bool finished() const { return _exited.load(); }
 
+	[[nodiscard]]
+	TaskState state() const { return _state; }
+
+	/// Effective priority of the task.
+	[[nodiscard]]
+	Priority priority() const { return _priority; }
+
+	/// Set base priority of the task.
+	void priority(Priority priority);
+
+	/// \brief Inherit priority.
+	///
+	/// Raise effective priority of the task up to specified one, e.g.
+	/// when a task with higher priority waits for a lock held by this one.
+	/// Every lock that boosts the task passes \p new_boost once and calls
+	/// \ref restore_priority when the task releases it.
+	void inherit_priority(Priority priority, bool new_boost);
+
+	/// \brief Drop inherited priority.
+	///
+	/// Effective priority returns to the base one when the last boost is
+	/// dropped.
+	void restore_priority();
+
 	constexpr
 	lib::IntrusiveListNode<Task>* tasks_list_node() { return &_tasks_list_node; }
 
 protected:
-	Task(Scheduler* creator, task_routine* routine, void* arg, const char *name = nullptr);
+	Task(Scheduler* creator, task_routine* routine, void* arg, const char *name,
+		size_t stack_size);
 
 private:
 	// start data
@@ -69,6 +119,7 @@ private:
 	const TaskId _id;
 	lib::atomic<bool> _exited{false};
 	lib::byte* _stack{};
+	size_t _stack_pages{};
 	char _name[16]{"<unknown>"};
 
 	lib::IntrusiveListNode<Task> _tasks_list_node{this};
@@ -77,8 +128,23 @@ private:
 
 	// state
 	void* _esp{nullptr};
+	TaskState _state{TaskState::runnable};
+	Priority _base_priority{Priority::normal};
+	Priority _priority{Priority::normal};
+	/// Number of locks held by the task that raised its priority.
+	uint32_t _boosts{0};
+	uint64_t _wake_at{0};
+	Task* _wait_next{nullptr};
+
+	/// Time of the last switch to the task; is used for round robin.
+	uint64_t _last_run{0};
+	/// Context of the task is in use by some CPU.
+	lib::atomic<bool> _on_cpu{false};
+	/// Task can't be moved to another CPU.
+	bool _pinned{false};
 
 	friend class Scheduler;
+	friend class WaitQueue;
 };
 
 lib::ostream& operator<<(lib::ostream& out, const Task& task);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <sched/task.hpp>
+
+namespace sched {
+
+
+/// \brief Queue of blocked tasks.
+///
+/// Tasks in the queue aren't scheduled until they are notified. Queue isn't
+/// protected by itself: all functions must be called under
+/// \ref thr::RecursiveIrqLocker together with the check of the condition that
+/// the task waits for, so that notification can't be lost.
+class WaitQueue {
+public:
+	WaitQueue() = default;
+
+	WaitQueue(const WaitQueue&) = delete;
+	WaitQueue& operator=(const WaitQueue&) = delete;
+
+
+	/// \brief Prepare current task to wait.
+	///
+	/// The function puts current task to the queue and blocks it. Task
+	/// continues execution until it yields.
+	void prepare_to_wait();
+
+
+	/// \brief Wait for notification.
+	///
+	/// The function blocks current task until it is notified. Interrupts
+	/// are enabled while the task waits and are disabled again on return.
+	void wait();
+
+
+	/// \brief Wake up one task.
+	///
+	/// The function wakes up the task with the highest priority.
+	///
+	/// \return false if there are no waiting tasks.
+	bool notify_one();
+
+
+	/// Wake up all waiting tasks.
+	void notify_all();
+
+
+	[[nodiscard]]
+	bool empty() const { return _head == nullptr; }
+
+private:
+	Task* _head{nullptr};
+	Task* _tail{nullptr};
+};
+
+
+} // namespace sched
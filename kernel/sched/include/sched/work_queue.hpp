@@ -0,0 +1,85 @@
+#pragma once
+
+#include <sched/task.hpp>
+#include <sched/wait_queue.hpp>
+
+namespace sched {
+
+
+/// \brief Item of deferred work.
+///
+/// Work is run by worker task of \ref WorkQueue, so unlike
+/// \ref irq::Tasklet it may sleep and yield.
+class Work {
+public:
+	using routine_type = void (void*);
+
+	Work(routine_type* routine, void* arg)
+		: _routine{routine}, _arg{arg}
+	{
+	}
+
+	Work(const Work&) = delete;
+	Work& operator =(const Work&) = delete;
+
+private:
+	routine_type* _routine;
+	void* _arg;
+	Work* _next{nullptr};
+	bool _queued{false};
+
+	friend class WorkQueue;
+};
+
+
+/// \brief Queue of deferred work.
+///
+/// Work items are processed one by one by dedicated kernel task that is
+/// blocked while the queue is empty.
+class WorkQueue {
+public:
+	explicit WorkQueue(const char* name)
+		: _name{name}
+	{
+	}
+
+	WorkQueue(const WorkQueue&) = delete;
+	WorkQueue& operator =(const WorkQueue&) = delete;
+
+
+	/// \brief Queue work.
+	///
+	/// The function may be called from any context including interrupt
+	/// handlers.
+	///
+	/// \return false if the work is already queued.
+	bool queue(Work* work);
+
+
+	/// \brief Start worker task.
+	///
+	/// Work that has been queued before start is processed once the
+	/// worker task is scheduled.
+	void start();
+
+
+	/// Work queue for general purpose.
+	static WorkQueue& system();
+
+private:
+	Work* take();
+
+	[[noreturn]]
+	void process();
+
+	static void worker_routine(void* queue);
+
+	const char* _name;
+	Work* _head{nullptr};
+	Work** _tail{&_head};
+	Task* _worker{nullptr};
+	WaitQueue _idle_worker{};
+};
+
+
+} // namespace sched
@@ -1,24 +1,55 @@
 #include "include/sched.hpp"
 
-#include <memory.hpp>
+#include <bolgenos-ng/tick.hpp>
 
 #include "scheduler.hpp"
 
-using namespace lib;
+namespace {
 
-static unique_ptr<sched::Scheduler> instance;
+/// Idle task of application processors.
+void idle_routine(void*) {
+	sched::current()->priority(sched::Priority::idle);
+	while (true) {
+		tick::idle();
+		sched::yield();
+	}
+}
+
+} // namespace
 
 void sched::yield() {
-	instance->yield();
+	if (auto scheduler = Scheduler::local()) {
+		scheduler->yield();
+	}
+}
+
+sched::Task* sched::create_task(sched::task_routine* routine, void* arg, const char* name,
+		size_t stack_size)
+{
+	return Scheduler::local()->create_task(routine, arg, name, stack_size);
+}
+
+
+sched::Task* sched::current()
+{
+	auto scheduler = Scheduler::local();
+	return scheduler ? scheduler->current() : nullptr;
 }
 
-sched::Task* sched::create_task(sched::task_routine* routine, void* arg, const char* name)
+
+void sched::sleep_until(uint64_t deadline_ns)
 {
-	return instance->create_task(routine, arg, name);
+	Scheduler::local()->sleep_until(deadline_ns);
 }
 
 
 void sched::details::init_scheduling(task_routine* main_continuation) {
-	instance = make_unique<Scheduler>(main_continuation);
-	instance->start_scheduling();
-}
\ No newline at end of file
+	auto scheduler = new Scheduler(main_continuation);
+	scheduler->start_scheduling();
+}
+
+
+void sched::details::start_cpu_scheduling() {
+	auto scheduler = new Scheduler(idle_routine);
+	scheduler->start_scheduling();
+}
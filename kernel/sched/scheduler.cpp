@@ -1,15 +1,31 @@
 #include "scheduler.hpp"
 
 #include <bolgenos-ng/irq.hpp>
+#include <threading/lock.hpp>
 #include <threading/with_lock.hpp>
 #include <bolgenos-ng/memory.hpp>
 #include <x86/cpu.hpp>
+#include <bolgenos-ng/tick.hpp>
+#include <bolgenos-ng/time.hpp>
+#include <bolgenos-ng/lapic.hpp>
+#include <algorithm.hpp>
+
+#include "config.h"
 
 using namespace lib;
 using namespace sched;
 using namespace x86;
 
 
+namespace {
+
+
+StackPool stack_pool_instance{};
+
+
+} // namespace
+
+
 void scheduling_task_routine(void *arg) {
 	static_cast<sched::Scheduler *>(arg)->schedule_forever();
 }
@@ -21,8 +37,9 @@ sched::Scheduler::Scheduler(task_routine* main_continuation)
 			panic("no main specified");
 		}
 		auto scheduler_task = create_task(scheduling_task_routine, this, "scheduler");
+		scheduler_task->_pinned = true;
 		_scheduler_task = scheduler_task;
-		create_task(main_continuation, nullptr, "main");
+		create_task(main_continuation, nullptr, "main")->_pinned = true;
 		_current = _scheduler_task;
 	});
 };
@@ -33,26 +50,85 @@ sched::Scheduler::Scheduler(task_routine* main_continuation)
 		panic("started scheduling with blocked interrupts");
 	}
 	WARN << "===== STARTED SCHEDULING =====" << endl;
-	constexpr bool debug_irq = false;
 	while (true) {
-		irq::disable(debug_irq);
-		for (auto task_ptr: _tasks) {
-			if (!should_schedule(task_ptr)) {
+		Task* next = thr::with_irq_lock([this]() {
+			return pick_next_task();
+		});
+		if (next) {
+			BLOG_INFO("scheduling to task #%u",
+				static_cast<uint32_t>(next->id()));
+			switch_to(next);
+			// Context of the task is saved, so other CPUs may take it.
+			next->_on_cpu.store(false, memory_order_release);
+		}
+		handle_finished_tasks();
+	}
+}
+
+Task* sched::Scheduler::pick_next_task()
+{
+	const uint64_t now = time::now_ns();
+	uint64_t next_wake = ~static_cast<uint64_t>(0);
+	Task* next = nullptr;
+	for (auto task_ptr: _tasks) {
+		if (is_runnable(task_ptr, now)) {
+			// The highest priority first; tasks of the same priority
+			// are run in round robin.
+			if (!next || task_ptr->priority() > next->priority()
+					|| (task_ptr->priority() == next->priority()
+						&& task_ptr->_last_run < next->_last_run)) {
+				next = task_ptr;
+			}
+		} else if (task_ptr->_state == TaskState::sleeping) {
+			next_wake = min(next_wake, task_ptr->_wake_at);
+		}
+	}
+	if (next_wake != ~static_cast<uint64_t>(0)) {
+		tick::request_event(next_wake);
+	}
+
+	if (SMP && (!next || next->priority() == Priority::idle)) {
+		if (auto stolen = steal_task(now)) {
+			next = stolen;
+		}
+	}
+
+	if (next) {
+		next->_last_run = now;
+		next->_on_cpu.store(true, memory_order_relaxed);
+	}
+	return next;
+}
+
+Task* sched::Scheduler::steal_task(uint64_t now)
+{
+	for (uint32_t index = 0; index < online_cpus(); ++index) {
+		auto cpu = cpu_by_index(index);
+		auto other = cpu ? static_cast<Scheduler*>(cpu->scheduler) : nullptr;
+		if (!other || other == this) {
+			continue;
+		}
+		for (auto task_ptr: other->_tasks) {
+			if (task_ptr->_pinned
+					|| task_ptr->_on_cpu.load(memory_order_acquire)
+					|| task_ptr->priority() == Priority::idle
+					|| !other->is_runnable(task_ptr, now)) {
 				continue;
 			}
-			INFO << "Scheduling to task [" << task_ptr->name() << "]" << endl;
-			irq::enable(debug_irq);
-			// switch_to knows better how to deal with interrupts
-			switch_to(task_ptr);
-			irq::disable(debug_irq);
+			BLOG_INFO("taking task #%u from CPU #%u",
+				static_cast<uint32_t>(task_ptr->id()), index);
+			other->_tasks.remove(task_ptr);
+			_tasks.insert(task_ptr);
+			task_ptr->_scheduler = this;
+			return task_ptr;
 		}
-		handle_finished_tasks();
-		irq::enable(debug_irq);
 	}
+	return nullptr;
 }
 
 void sched::Scheduler::start_scheduling()
 {
+	this_cpu()->scheduler = this;
 	INFO << "switching into itself to fill task data" << endl;
 	switch_to(_scheduler_task);
 
@@ -71,10 +147,10 @@ struct [[gnu::packed]] NewTaskStack {
 
 static_assert(sizeof(NewTaskStack) == 20);
 
-Task* sched::Scheduler::create_task(task_routine* routine, void* arg, const char* name)
+Task* sched::Scheduler::create_task(task_routine* routine, void* arg, const char* name,
+		size_t stack_size)
 {
-	auto* task = new Task{this, routine, arg, name};
-	_tasks.insert(task);
+	auto* task = new Task{this, routine, arg, name, stack_size};
 
 	auto* new_task_stack = reinterpret_cast<NewTaskStack*>(task->_esp) - 1;
 	new_task_stack->eip = Task::start_on_new_frame;
@@ -84,6 +160,12 @@ Task* sched::Scheduler::create_task(task_routine* routine, void* arg, const char
 	new_task_stack->ebp2 = new_task_stack->ebp1;
 	new_task_stack->flags = Processor::flags();
 	task->_esp = new_task_stack;
+	// Other CPUs walk the run queue under kernel lock when they steal
+	// tasks, and may run the task as soon as it's inserted.
+	thr::with_irq_lock([&]() {
+		_tasks.insert(task);
+	});
+	kick_other_cpus();
 	return task;
 }
 
@@ -95,12 +177,17 @@ void sched::Scheduler::switch_to(Task* task)
 	irq::disable(false);
 
 	auto prev = _current;
-	INFO << "Switch: [" << prev->name() << "](" << prev->id() << ")"
-	      << " -> " << *task << endl;
+	BLOG_INFO("switch: #%u -> #%u", static_cast<uint32_t>(prev->id()),
+		static_cast<uint32_t>(task->id()));
 	_current = task;
+	// Kernel lock is owned by CPU rather than by task, so it's released
+	// for the time while other tasks run. Task may be continued on
+	// another CPU.
+	const uint32_t kernel_lock_depth = thr::details::drop_kernel_lock();
 	switch_tasks_impl(prev, task);
+	thr::details::restore_kernel_lock(kernel_lock_depth);
 	irq::enable(false);
-	INFO << "returned from switch" << endl;
+	BLOG_INFO("returned from switch");
 }
 
 [[gnu::cdecl, gnu::noinline]]
@@ -124,14 +211,29 @@ void sched::Scheduler::switch_tasks_impl(Task* prev, Task* next) {
 
 void sched::Scheduler::yield()
 {
-	INFO << "yielding" << endl;
+	BLOG_INFO("yielding");
 	switch_to(_scheduler_task);
 }
 
-bool sched::Scheduler::should_schedule(const Task* task)
+void sched::Scheduler::sleep_until(uint64_t deadline_ns)
 {
-	return task != _scheduler_task &&
-		!task->finished();
+	thr::with_irq_lock([&]() {
+		_current->_wake_at = deadline_ns;
+		_current->_state = TaskState::sleeping;
+		tick::request_event(deadline_ns);
+	});
+	yield();
+}
+
+bool sched::Scheduler::is_runnable(Task* task, uint64_t now)
+{
+	if (task == _scheduler_task || task->finished()) {
+		return false;
+	}
+	if (task->_state == TaskState::sleeping && task->_wake_at <= now) {
+		task->_state = TaskState::runnable;
+	}
+	return task->_state == TaskState::runnable;
 }
 
 void sched::Scheduler::handle_exit(Task* task)
@@ -142,13 +244,40 @@ void sched::Scheduler::handle_exit(Task* task)
 	yield();
 }
 
+StackPool& Scheduler::stack_pool()
+{
+	return stack_pool_instance;
+}
+
+void Scheduler::kick_other_cpus()
+{
+	if (SMP && online_cpus() > 1) {
+		lapic::send_ipi_all_but_self(lapic::reschedule_vector);
+	}
+}
+
+Scheduler* Scheduler::local()
+{
+	return static_cast<Scheduler*>(this_cpu()->scheduler);
+}
+
 void Scheduler::handle_finished_tasks()
 {
-	thr::with_irq_lock([&]() {
-		for (auto task_ptr: _finished_tasks) {
-			_tasks.remove(task_ptr);
-			delete task_ptr;
+	// Only unlinking requires disabled interrupts; tasks are deleted
+	// with enabled ones.
+	while (true) {
+		auto task_ptr = thr::with_irq_lock([&]() -> Task* {
+			if (_finished_tasks.empty()) {
+				return nullptr;
+			}
+			auto finished = _finished_tasks.front();
+			_finished_tasks.pop_front();
+			_tasks.remove(finished);
+			return finished;
+		});
+		if (!task_ptr) {
+			break;
 		}
-		_finished_tasks.clear();
-	});
+		delete task_ptr;
+	}
 }
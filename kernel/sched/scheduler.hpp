@@ -10,6 +10,8 @@
 #include <loggable.hpp>
 #include <sched/task.hpp>
 
+#include "stack_pool.hpp"
+
 namespace sched {
 
 class Scheduler: private Loggable("scheduler")
@@ -28,12 +30,28 @@ public:
 	[[noreturn]]
 	void start_scheduling();
 
-	Task* create_task(task_routine* routine, void* arg, const char* name = nullptr);
+	Task* create_task(task_routine* routine, void* arg, const char* name = nullptr,
+		size_t stack_size = 0);
 
 	void handle_exit(Task* task);
 
 	void yield();
 
+	void sleep_until(uint64_t deadline_ns);
+
+	Task* current() { return _current; }
+
+	/// Pool of stacks shared by schedulers of all CPUs.
+	static StackPool& stack_pool();
+
+	/// \brief Scheduler of the current CPU.
+	///
+	/// \return nullptr if the CPU doesn't schedule tasks yet.
+	static Scheduler* local();
+
+	/// Ask other CPUs to look for tasks to run, e.g. to take a new one.
+	static void kick_other_cpus();
+
 	[[maybe_unused]] [[noreturn]] [[gnu::thiscall]]
 	void schedule_forever();
 
@@ -43,9 +61,19 @@ public:
 private:
 	void switch_to(Task* task);
 
-	bool should_schedule(const Task* task);
+	bool is_runnable(Task* task, uint64_t now);
 	void handle_finished_tasks();
 
+	/// \brief Choose task to run.
+	///
+	/// Must be called with the kernel lock held.
+	Task* pick_next_task();
+
+	/// \brief Take runnable task from scheduler of another CPU.
+	///
+	/// Must be called with the kernel lock held.
+	Task* steal_task(uint64_t now);
+
 	lib::CircularIntrusiveList<Task> _tasks{&Task::tasks_list_node};
 	lib::forward_list<Task*> _finished_tasks{};
 	Task* _scheduler_task{nullptr};
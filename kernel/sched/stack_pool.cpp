@@ -0,0 +1,77 @@
+#include "stack_pool.hpp"
+
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/memory.hpp>
+#include <threading/with_lock.hpp>
+
+#include <config.h>
+
+using namespace lib;
+using namespace sched;
+
+
+size_t StackPool::pages_for(size_t stack_size)
+{
+	size_t pages = 1;
+	while (pages * PAGE_SIZE < stack_size) {
+		pages *= 2;
+	}
+	return pages;
+}
+
+
+size_t StackPool::order_of(size_t pages)
+{
+	size_t order = 0;
+	while ((static_cast<size_t>(1) << order) < pages) {
+		++order;
+	}
+	return order;
+}
+
+
+byte* StackPool::allocate(size_t pages)
+{
+	const size_t order = order_of(pages);
+	byte* stack = nullptr;
+
+	if (order < ORDERS) {
+		stack = thr::with_lock(_lock, [&]() -> byte* {
+			FreeStack* cached = _free[order];
+			if (cached) {
+				_free[order] = cached->next;
+				--_cached[order];
+			}
+			return reinterpret_cast<byte*>(cached);
+		});
+	}
+
+	if (!stack) {
+		stack = static_cast<byte*>(memory::alloc_pages(pages));
+	}
+	if (!stack) {
+		panic("failed to allocate task stack");
+	}
+	return stack;
+}
+
+
+void StackPool::release(byte* stack, size_t pages)
+{
+	const size_t order = order_of(pages);
+
+	const bool cached = order < ORDERS && thr::with_lock(_lock, [&]() -> bool {
+		if (_cached[order] == MAX_CACHED) {
+			return false;
+		}
+		auto free_stack = reinterpret_cast<FreeStack*>(stack);
+		free_stack->next = _free[order];
+		_free[order] = free_stack;
+		++_cached[order];
+		return true;
+	});
+
+	if (!cached) {
+		memory::free_pages(stack);
+	}
+}
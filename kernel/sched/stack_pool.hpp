@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef.hpp>
+
+#include <threading/spinlock.hpp>
+
+namespace sched {
+
+/// \brief Pool of task stacks.
+///
+/// Stacks of removed tasks are kept in per-size free lists and are reused
+/// by new tasks instead of going through the page allocator. Stack sizes
+/// are rounded up to power-of-two number of pages.
+class StackPool
+{
+public:
+	StackPool() = default;
+
+	StackPool(const StackPool&) = delete;
+
+	StackPool& operator=(const StackPool&) = delete;
+
+	/// \brief Allocate stack.
+	///
+	/// \param pages Number of pages, see \ref pages_for.
+	/// \return Pointer to the lowest address of the stack.
+	lib::byte* allocate(size_t pages);
+
+	/// \brief Release stack.
+	///
+	/// \param stack Stack returned by \ref allocate.
+	/// \param pages Number of pages that was passed to \ref allocate.
+	void release(lib::byte* stack, size_t pages);
+
+	/// Number of pages in stack of at least specified size.
+	static size_t pages_for(size_t stack_size);
+
+private:
+	/// Number of supported sizes. Bigger stacks aren't cached.
+	static constexpr size_t ORDERS = 5;
+
+	/// Maximal number of cached stacks of each size.
+	static constexpr size_t MAX_CACHED = 8;
+
+	struct FreeStack {
+		FreeStack* next;
+	};
+
+	static size_t order_of(size_t pages);
+
+	FreeStack* _free[ORDERS]{};
+	size_t _cached[ORDERS]{};
+	thr::IrqSpinLock _lock{"stack_pool"};
+};
+
+} // namespace sched
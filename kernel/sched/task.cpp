@@ -1,11 +1,11 @@
 #include "include/sched/task.hpp"
 
 #include <config.h>
-#include <ext/scoped_format_guard.hpp>
 #include <atomic.hpp>
 #include <cstring.hpp>
-#include <bolgenos-ng/memory.hpp>
+#include <format.hpp>
 #include <bolgenos-ng/irq.hpp>
+#include <threading/with_lock.hpp>
 
 #include "scheduler.hpp"
 
@@ -18,8 +18,7 @@ static lib::atomic<uint32_t> next_task_id{0};
 
 
 lib::ostream& sched::operator<<(lib::ostream& out, TaskId id) {
-	ScopedFormatGuard guard{out};
-	return out << dec << static_cast<underlying_type_t<TaskId>>(id);
+	return lib::format_to(out, "{}", static_cast<underlying_type_t<TaskId>>(id));
 }
 
 static TaskId allocate_task_id() {
@@ -27,22 +26,20 @@ static TaskId allocate_task_id() {
 }
 
 lib::ostream& sched::operator<<(lib::ostream& out, const Task& task) {
-	ScopedFormatGuard guard{out};
-	return out << "Task[" << task.name() << "](" << task.id() << ")"
-		<< "{.esp=" << hex << task.esp()
-		<< ",.stack=" << task.stack()
-		<< "}";
+	return lib::format_to(out, "Task[{}]({}){{.esp={:x},.stack={:x},.stack_size={:x}}}",
+		task.name(), task.id(), task.esp(), task.stack(), task.stack_size());
 }
 
-Task::Task(Scheduler* creator, task_routine* routine, void* arg, const char* name_) :
+Task::Task(Scheduler* creator, task_routine* routine, void* arg, const char* name_,
+		size_t stack_size) :
 	_routine{routine},
 	_arg{arg},
 	_id{allocate_task_id()},
+	_stack_pages{StackPool::pages_for(stack_size ? stack_size : TASK_STACK_SIZE)},
 	_scheduler{creator}
 {
-	static constexpr size_t stack_pages = 16;
-	_stack = reinterpret_cast<byte*>(memory::alloc_pages(stack_pages));
-	_esp = _stack + PAGE_SIZE*stack_pages;
+	_stack = Scheduler::stack_pool().allocate(_stack_pages);
+	_esp = _stack + PAGE_SIZE*_stack_pages;
 	name(name_);
 }
 
@@ -53,9 +50,11 @@ void sched::Task::run()
 	_routine(_arg);
 	_exited.store(true);
 	NOTICE << "Finished task " << *this << endl;
-	_scheduler->handle_exit(this);
+	// Task may have been moved to another CPU, so the scheduler of the
+	// current one is used.
+	Scheduler::local()->handle_exit(this);
 	while (true) {
-		_scheduler->yield();
+		Scheduler::local()->yield();
 	}
 }
 
@@ -63,6 +62,42 @@ void sched::Task::run()
 	task->run();
 }
 
+void Task::priority(Priority priority)
+{
+	thr::with_irq_lock([&]() {
+		if (_boosts == 0 || priority > _priority) {
+			_priority = priority;
+		}
+		_base_priority = priority;
+	});
+}
+
+void Task::inherit_priority(Priority priority, bool new_boost)
+{
+	thr::with_irq_lock([&]() {
+		if (new_boost) {
+			++_boosts;
+		}
+		if (priority > _priority) {
+			_priority = priority;
+		}
+	});
+}
+
+void Task::restore_priority()
+{
+	thr::with_irq_lock([&]() {
+		if (_boosts && --_boosts == 0) {
+			_priority = _base_priority;
+		}
+	});
+}
+
+size_t Task::stack_size() const
+{
+	return _stack_pages * PAGE_SIZE;
+}
+
 void Task::name(const char* name)
 {
 	strncpy(_name, name, sizeof(_name) - 1);
@@ -72,7 +107,7 @@ void Task::name(const char* name)
 Task::~Task()
 {
 	NOTICE << "Removing task " << *this << endl;
-	memory::free_pages(_stack);
+	Scheduler::stack_pool().release(_stack, _stack_pages);
 	_stack = nullptr;
 }
 
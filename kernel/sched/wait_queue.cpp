@@ -0,0 +1,80 @@
+#include <sched/wait_queue.hpp>
+
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/irq.hpp>
+#include <sched.hpp>
+
+#include "scheduler.hpp"
+
+using namespace sched;
+
+
+void WaitQueue::prepare_to_wait()
+{
+	Task* task = sched::current();
+	if (!task) {
+		panic("waiting without scheduler");
+	}
+	if (irq::in_interrupt()) {
+		panic("waiting in interrupt handler");
+	}
+
+	task->_state = TaskState::blocked;
+	task->_wait_next = nullptr;
+	if (_tail) {
+		_tail->_wait_next = task;
+	} else {
+		_head = task;
+	}
+	_tail = task;
+}
+
+
+void WaitQueue::wait()
+{
+	prepare_to_wait();
+	irq::enable(false);
+	sched::yield();
+	irq::disable(false);
+}
+
+
+bool WaitQueue::notify_one()
+{
+	if (!_head) {
+		return false;
+	}
+
+	Task* prev = nullptr;
+	Task* best_prev = nullptr;
+	Task* best = _head;
+	for (Task* task = _head; task; prev = task, task = task->_wait_next) {
+		if (task->priority() > best->priority()) {
+			best = task;
+			best_prev = prev;
+		}
+	}
+
+	if (best_prev) {
+		best_prev->_wait_next = best->_wait_next;
+	} else {
+		_head = best->_wait_next;
+	}
+	if (_tail == best) {
+		_tail = best_prev;
+	}
+
+	best->_wait_next = nullptr;
+	best->_state = TaskState::runnable;
+	if (best->_scheduler != Scheduler::local()) {
+		Scheduler::kick_other_cpus();
+	}
+	return true;
+}
+
+
+void WaitQueue::notify_all()
+{
+	while (notify_one()) {
+	}
+}
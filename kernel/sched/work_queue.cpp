@@ -0,0 +1,72 @@
+#include <sched/work_queue.hpp>
+
+#include <bolgenos-ng/error.h>
+#include <sched.hpp>
+#include <threading/with_lock.hpp>
+
+using namespace sched;
+
+
+bool WorkQueue::queue(Work* work)
+{
+	return thr::with_irq_lock([&]() -> bool {
+		if (work->_queued) {
+			return false;
+		}
+		work->_queued = true;
+		work->_next = nullptr;
+		*_tail = work;
+		_tail = &work->_next;
+		_idle_worker.notify_one();
+		return true;
+	});
+}
+
+
+Work* WorkQueue::take()
+{
+	return thr::with_irq_lock([&]() -> Work* {
+		while (!_head) {
+			_idle_worker.wait();
+		}
+
+		Work* work = _head;
+		_head = work->_next;
+		if (!_head) {
+			_tail = &_head;
+		}
+		work->_queued = false;
+		return work;
+	});
+}
+
+
+void WorkQueue::process()
+{
+	while (true) {
+		Work* work = take();
+		work->_routine(work->_arg);
+	}
+}
+
+
+void WorkQueue::worker_routine(void* queue)
+{
+	static_cast<WorkQueue*>(queue)->process();
+}
+
+
+void WorkQueue::start()
+{
+	if (_worker) {
+		panic("work queue is started twice");
+	}
+	_worker = sched::create_task(worker_routine, this, _name);
+}
+
+
+WorkQueue& WorkQueue::system()
+{
+	static WorkQueue system_queue{"kworker"};
+	return system_queue;
+}
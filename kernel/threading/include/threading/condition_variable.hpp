@@ -0,0 +1,44 @@
+#pragma once
+
+#include <sched/wait_queue.hpp>
+
+#include "mutex.hpp"
+
+namespace thr {
+
+
+/// \brief Condition variable.
+///
+/// Condition variable that works together with \ref Mutex. Notification
+/// functions may be called by interrupt handlers.
+class ConditionVariable {
+public:
+	ConditionVariable() = default;
+
+	ConditionVariable(const ConditionVariable&) = delete;
+	ConditionVariable& operator=(const ConditionVariable&) = delete;
+
+	/// \brief Wait for notification.
+	///
+	/// The function atomically releases the mutex and blocks current task
+	/// until notification. The mutex is locked again before return.
+	void wait(Mutex& mutex);
+
+	/// Wait until predicate becomes true.
+	template<typename Predicate>
+	void wait(Mutex& mutex, Predicate pred) {
+		while (!pred()) {
+			wait(mutex);
+		}
+	}
+
+	void notify_one();
+
+	void notify_all();
+
+private:
+	sched::WaitQueue _waiters{};
+};
+
+
+} // namespace thr
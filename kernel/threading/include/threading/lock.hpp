@@ -1,16 +1,23 @@
 #pragma once
 
+#include <cstdint.hpp>
 #include <mutex.hpp>
 
 namespace thr {
 
 
+/// \brief Lock of short critical sections.
+///
+/// The lock disables interrupts of the current CPU and, once other CPUs
+/// are started, takes the kernel lock that serializes such critical sections
+/// between CPUs. Both may be taken recursively.
 class RecursiveIrqLocker {
 public:
 	void lock();
 	void unlock();
 private:
 	bool _enable_on_unlock{};
+	bool _kernel_locked{};
 };
 
 
@@ -23,4 +30,30 @@ private:
 	lib::lock_guard<RecursiveIrqLocker> _lock_guard;
 };
 
+
+namespace details {
+
+
+/// \brief Start using the kernel lock.
+///
+/// The function must be called before other CPUs are started.
+void enable_kernel_lock();
+
+
+/// \brief Release the kernel lock before switching to another task.
+///
+/// Critical sections of \ref RecursiveIrqLocker that block current task
+/// must release the kernel lock, since other tasks run on this CPU.
+///
+/// \return Recursion depth to be passed to \ref restore_kernel_lock.
+uint32_t drop_kernel_lock();
+
+
+/// Take the kernel lock released by \ref drop_kernel_lock.
+void restore_kernel_lock(uint32_t depth);
+
+
+} // namespace details
+
+
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <sched/wait_queue.hpp>
+
+namespace thr {
+
+
+/// \brief Sleeping mutex.
+///
+/// Tasks that wait for the mutex are blocked and don't consume CPU time.
+/// Interrupts are disabled only for short internal bookkeeping, so critical
+/// sections protected by the mutex run with enabled interrupts.
+///
+/// Owner of the mutex inherits priority of the waiting tasks, so that task
+/// with lower priority can't keep the mutex for unbounded time. Only direct
+/// inheritance is tracked: owner's priority is restored to its base priority
+/// when it unlocks the last mutex that boosted it.
+///
+/// \warning Mutex can't be used by interrupt handlers.
+class Mutex {
+public:
+	Mutex() = default;
+
+	Mutex(const Mutex&) = delete;
+	Mutex& operator=(const Mutex&) = delete;
+
+	void lock();
+
+	[[nodiscard]]
+	bool try_lock();
+
+	void unlock();
+
+	/// Task that owns the mutex.
+	[[nodiscard]]
+	sched::Task* owner() const { return _owner; }
+
+private:
+	bool _locked{false};
+	sched::Task* _owner{nullptr};
+	/// Owner's priority was raised by waiters of this mutex.
+	bool _boosted{false};
+	sched::WaitQueue _waiters{};
+
+	friend class ConditionVariable;
+};
+
+
+} // namespace thr
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef.hpp>
+
+#include <sched/wait_queue.hpp>
+
+namespace thr {
+
+
+/// \brief Counting semaphore.
+///
+/// Tasks that wait for the semaphore are blocked. \ref release may be called
+/// by interrupt handlers.
+class Semaphore {
+public:
+	explicit Semaphore(size_t count = 0)
+		: _count{count}
+	{
+	}
+
+	Semaphore(const Semaphore&) = delete;
+	Semaphore& operator=(const Semaphore&) = delete;
+
+	/// Decrement counter, waiting until it is positive.
+	void acquire();
+
+	/// Decrement counter if it is positive.
+	[[nodiscard]]
+	bool try_acquire();
+
+	/// Increment counter and wake up one waiting task.
+	void release();
+
+private:
+	size_t _count;
+	sched::WaitQueue _waiters{};
+};
+
+
+} // namespace thr
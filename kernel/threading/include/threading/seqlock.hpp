@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic.hpp>
+#include <cstdint.hpp>
+#include <utility.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+
+#include "spinlock.hpp"
+
+namespace thr {
+
+
+/// \brief Sequence counter.
+///
+/// Counter lets readers take consistent snapshot of multi-word data without
+/// locking: reader repeats reading while writer changes the data. Readers
+/// never block writer and never disable interrupts.
+///
+/// Counter doesn't serialize writers. Writer must not be interrupted by a
+/// reader of the same data, otherwise the reader spins forever: on single
+/// CPU writer must run with disabled interrupts if data is read by
+/// interrupt handlers. Use \ref SeqLock if unsure.
+class SeqCount {
+public:
+	SeqCount() = default;
+
+	SeqCount(const SeqCount&) = delete;
+	SeqCount& operator=(const SeqCount&) = delete;
+
+
+	/// \brief Start reading.
+	///
+	/// \return Sequence number to be passed to \ref read_retry.
+	uint32_t read_begin() const {
+		uint32_t sequence;
+		while ((sequence = _sequence.load(lib::memory_order_acquire)) & 1) {
+			x86::cpu_relax();
+		}
+		return sequence;
+	}
+
+
+	/// \brief Finish reading.
+	///
+	/// \return true if data was changed while reading and read must be
+	///	repeated.
+	bool read_retry(uint32_t sequence) const {
+		lib::atomic_thread_fence(lib::memory_order_acquire);
+		return _sequence.load(lib::memory_order_relaxed) != sequence;
+	}
+
+
+	/// \brief Read data consistently.
+	///
+	/// \param reader Function that reads data and returns its copy.
+	/// \return Result of the latest call of \p reader.
+	template<typename F>
+	auto read(F&& reader) const {
+		uint32_t sequence;
+		decltype(reader()) result;
+		do {
+			sequence = read_begin();
+			result = reader();
+		} while (read_retry(sequence));
+		return result;
+	}
+
+
+	void write_begin() {
+		_sequence.store(_sequence.load(lib::memory_order_relaxed) + 1,
+			lib::memory_order_relaxed);
+		lib::atomic_thread_fence(lib::memory_order_release);
+	}
+
+
+	void write_end() {
+		_sequence.store(_sequence.load(lib::memory_order_relaxed) + 1,
+			lib::memory_order_release);
+	}
+
+private:
+	/// Odd value means that writer is changing the data.
+	lib::atomic<uint32_t> _sequence{0};
+};
+
+
+/// \brief Sequence lock.
+///
+/// Sequence counter with a spinlock that serializes writers. Writers
+/// disable interrupts, so the data may be written and read by both tasks and
+/// interrupt handlers.
+class SeqLock {
+public:
+	constexpr explicit SeqLock(const char* name = nullptr)
+		: _lock{name}
+	{
+	}
+
+	SeqLock(const SeqLock&) = delete;
+	SeqLock& operator=(const SeqLock&) = delete;
+
+
+	uint32_t read_begin() const { return _count.read_begin(); }
+
+	bool read_retry(uint32_t sequence) const {
+		return _count.read_retry(sequence);
+	}
+
+	/// \copydoc SeqCount::read
+	template<typename F>
+	auto read(F&& reader) const {
+		return _count.read(lib::forward<F>(reader));
+	}
+
+
+	void write_lock() {
+		_lock.lock();
+		_count.write_begin();
+	}
+
+
+	void write_unlock() {
+		_count.write_end();
+		_lock.unlock();
+	}
+
+
+	/// \brief Change data under the lock.
+	///
+	/// \param writer Function that changes data.
+	template<typename F>
+	void write(F&& writer) {
+		write_lock();
+		writer();
+		write_unlock();
+	}
+
+private:
+	IrqSpinLock _lock;
+	SeqCount _count{};
+};
+
+
+} // namespace thr
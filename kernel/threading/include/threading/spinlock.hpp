@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic.hpp>
+#include <cstdint.hpp>
+#include <ostream.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/irq_trace.hpp>
+
+#include "config.h"
+
+namespace thr {
+
+
+/// \brief Statistics of lock usage.
+///
+/// Statistics are collected only if LOCK_STATS option is enabled. All
+/// counters are updated by the lock owner, so they are protected by the lock
+/// itself. Times are measured in TSC cycles.
+struct LockStats {
+	/// Number of times the lock was taken.
+	uint32_t acquisitions;
+
+	/// Number of times the lock was found taken by someone else.
+	uint32_t contentions;
+
+	/// Total time spent waiting for the lock.
+	uint64_t wait_cycles;
+
+	/// Total time the lock was held.
+	uint64_t hold_cycles;
+
+	/// Longest time the lock was held.
+	uint64_t max_hold_cycles;
+};
+
+
+/// \brief Ticket spinlock.
+///
+/// Waiters get the lock in the order they asked for it. The lock doesn't
+/// touch interrupt flag, so it must not be taken by interrupt handlers
+/// unless all other users disable interrupts: use \ref IrqSpinLock for that.
+///
+/// Named locks are listed by \ref print_lock_stats.
+class SpinLock {
+public:
+	constexpr explicit SpinLock(const char* name = nullptr)
+		: _name{name}
+	{
+	}
+
+	SpinLock(const SpinLock&) = delete;
+	SpinLock& operator=(const SpinLock&) = delete;
+
+	inline void lock();
+
+	[[nodiscard]]
+	inline bool try_lock();
+
+	inline void unlock();
+
+	/// Check if the lock is taken by anyone.
+	[[nodiscard]]
+	bool is_locked() const {
+		return _next.load() != _owner.load();
+	}
+
+	[[nodiscard]]
+	const char* name() const { return _name; }
+
+#if LOCK_STATS
+	[[nodiscard]]
+	const LockStats& stats() const { return _stats; }
+#endif
+
+private:
+	/// Next ticket to be given to the waiter.
+	lib::atomic<uint16_t> _next{0};
+
+	/// Ticket that owns the lock.
+	lib::atomic<uint16_t> _owner{0};
+
+	const char* _name;
+
+#if LOCK_STATS
+	void account_acquire(uint64_t wait_start, bool contended);
+	void account_release();
+
+	LockStats _stats{};
+	uint64_t _acquired_at{0};
+	bool _registered{false};
+	SpinLock* _next_registered{nullptr};
+
+	friend void print_lock_stats(lib::ostream&);
+#endif
+};
+
+
+/// \brief Spinlock that disables interrupts.
+///
+/// The lock saves EFLAGS and disables interrupts before taking the
+/// spinlock, and restores them after release. It is safe to take the lock
+/// both from tasks and from interrupt handlers. Held lock is traced as
+/// section with disabled interrupts.
+class IrqSpinLock {
+public:
+	constexpr explicit IrqSpinLock(const char* name = nullptr)
+		: _lock{name}
+	{
+	}
+
+	IrqSpinLock(const IrqSpinLock&) = delete;
+	IrqSpinLock& operator=(const IrqSpinLock&) = delete;
+
+	void lock() {
+		const uint32_t flags = irq::trace::save_flags_and_cli();
+		_lock.lock();
+		_flags = flags;
+	}
+
+	[[nodiscard]]
+	bool try_lock() {
+		const uint32_t flags = irq::trace::save_flags_and_cli();
+		if (!_lock.try_lock()) {
+			irq::trace::restore_flags(flags);
+			return false;
+		}
+		_flags = flags;
+		return true;
+	}
+
+	void unlock() {
+		const uint32_t flags = _flags;
+		_lock.unlock();
+		irq::trace::restore_flags(flags);
+	}
+
+	[[nodiscard]]
+	bool is_locked() const { return _lock.is_locked(); }
+
+	[[nodiscard]]
+	SpinLock& raw() { return _lock; }
+
+private:
+	SpinLock _lock;
+
+	/// EFLAGS of the owner before the lock was taken.
+	uint32_t _flags{0};
+};
+
+
+/// \brief Print statistics of named locks.
+///
+/// The function prints statistics of named locks that were taken at least
+/// once. If LOCK_STATS option is disabled, nothing but notice is printed.
+void print_lock_stats(lib::ostream& out);
+
+
+void SpinLock::lock()
+{
+#if LOCK_STATS
+	const uint64_t wait_start = x86::read_tsc();
+#endif
+	const uint16_t ticket = _next.fetch_add(1);
+	bool contended = false;
+	while (_owner.load() != ticket) {
+		contended = true;
+		x86::cpu_relax();
+	}
+#if LOCK_STATS
+	account_acquire(wait_start, contended);
+#else
+	(void) contended;
+#endif
+}
+
+
+bool SpinLock::try_lock()
+{
+	const uint16_t owner = _owner.load();
+	if (!_next.compare_exchange(owner, static_cast<uint16_t>(owner + 1))) {
+		return false;
+	}
+#if LOCK_STATS
+	account_acquire(x86::read_tsc(), false);
+#endif
+	return true;
+}
+
+
+void SpinLock::unlock()
+{
+#if LOCK_STATS
+	account_release();
+#endif
+	// Only owner changes the field, so there is no need in locked
+	// increment; x86 stores have release semantics.
+	_owner.store(static_cast<uint16_t>(_owner.load() + 1));
+}
+
+
+} // namespace thr
@@ -1,4 +1,9 @@
 #pragma once
 
+#include "condition_variable.hpp"
 #include "lock.hpp"
+#include "mutex.hpp"
+#include "semaphore.hpp"
+#include "seqlock.hpp"
+#include "spinlock.hpp"
 #include "with_lock.hpp"
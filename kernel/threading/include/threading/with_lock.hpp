@@ -14,6 +14,12 @@ inline auto with_lock(F&& f) {
 	return f();
 }
 
+template<typename Lock, typename F>
+inline auto with_lock(Lock& lock, F&& f) {
+	lib::lock_guard guard{lock};
+	return f();
+}
+
 template<typename F>
 inline auto with_irq_lock(F&& f) {
 	return with_lock<RecursiveIrqLocker>(lib::forward<F>(f));
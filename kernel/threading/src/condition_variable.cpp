@@ -0,0 +1,32 @@
+#include <threading/condition_variable.hpp>
+
+#include <bolgenos-ng/irq.hpp>
+#include <sched.hpp>
+
+#include <threading/with_lock.hpp>
+
+void thr::ConditionVariable::wait(Mutex& mutex)
+{
+	thr::with_irq_lock([&]() {
+		_waiters.prepare_to_wait();
+		mutex.unlock();
+		irq::enable(false);
+		sched::yield();
+		irq::disable(false);
+	});
+	mutex.lock();
+}
+
+void thr::ConditionVariable::notify_one()
+{
+	thr::with_irq_lock([this]() {
+		_waiters.notify_one();
+	});
+}
+
+void thr::ConditionVariable::notify_all()
+{
+	thr::with_irq_lock([this]() {
+		_waiters.notify_all();
+	});
+}
@@ -1,14 +1,73 @@
 #include <threading/lock.hpp>
 
+#include <atomic.hpp>
+
 #include <bolgenos-ng/irq.hpp>
+#include <threading/spinlock.hpp>
+#include <x86/percpu.hpp>
+
+namespace {
+
+
+/// Kernel lock is used; is set when other CPUs are started.
+lib::atomic<bool> kernel_lock_enabled{false};
+
+thr::SpinLock kernel_lock{"kernel"};
+
+/// CPU that holds the kernel lock.
+lib::atomic<x86::PerCpu*> kernel_lock_owner{nullptr};
+
+/// Recursion depth of the kernel lock; is changed only by owner.
+uint32_t kernel_lock_depth = 0;
+
+
+/// \brief Take the kernel lock.
+///
+/// Interrupts must be disabled.
+///
+/// \return true if the lock was taken.
+bool acquire_kernel_lock()
+{
+	if (!kernel_lock_enabled.load(lib::memory_order_relaxed)) {
+		return false;
+	}
+
+	auto cpu = x86::this_cpu();
+	if (kernel_lock_owner.load(lib::memory_order_relaxed) == cpu) {
+		++kernel_lock_depth;
+		return true;
+	}
+
+	kernel_lock.lock();
+	kernel_lock_owner.store(cpu, lib::memory_order_relaxed);
+	kernel_lock_depth = 1;
+	return true;
+}
+
+
+void release_kernel_lock()
+{
+	if (--kernel_lock_depth == 0) {
+		kernel_lock_owner.store(nullptr, lib::memory_order_relaxed);
+		kernel_lock.unlock();
+	}
+}
+
+
+} // namespace
+
 
 void thr::RecursiveIrqLocker::lock()
 {
 	_enable_on_unlock = irq::disable(false);
+	_kernel_locked = acquire_kernel_lock();
 }
 
 void thr::RecursiveIrqLocker::unlock()
 {
+	if (_kernel_locked) {
+		release_kernel_lock();
+	}
 	if (_enable_on_unlock) {
 		irq::enable(false);
 	}
@@ -21,3 +80,32 @@ thr::RecursiveIrqGuard::RecursiveIrqGuard()
 }
 
 thr::RecursiveIrqGuard::~RecursiveIrqGuard() = default;
+
+void thr::details::enable_kernel_lock()
+{
+	kernel_lock_enabled.store(true);
+}
+
+uint32_t thr::details::drop_kernel_lock()
+{
+	if (kernel_lock_owner.load(lib::memory_order_relaxed) != x86::this_cpu()) {
+		return 0;
+	}
+
+	const uint32_t depth = kernel_lock_depth;
+	kernel_lock_depth = 0;
+	kernel_lock_owner.store(nullptr, lib::memory_order_relaxed);
+	kernel_lock.unlock();
+	return depth;
+}
+
+void thr::details::restore_kernel_lock(uint32_t depth)
+{
+	if (!depth) {
+		return;
+	}
+
+	kernel_lock.lock();
+	kernel_lock_owner.store(x86::this_cpu(), lib::memory_order_relaxed);
+	kernel_lock_depth = depth;
+}
@@ -1,3 +1,63 @@
-#include <mutex.hpp>
+#include <threading/mutex.hpp>
 
-// just for compile test
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/irq.hpp>
+#include <sched.hpp>
+
+#include <threading/with_lock.hpp>
+
+void thr::Mutex::lock()
+{
+	if (irq::in_interrupt()) {
+		panic("locking mutex in interrupt handler");
+	}
+
+	thr::with_irq_lock([this]() {
+		auto self = sched::current();
+		while (_locked) {
+			if (!self) {
+				panic("mutex contention before scheduling");
+			}
+			if (_owner == self) {
+				panic("recursive locking of mutex");
+			}
+			// Mutex taken before scheduling has no owner task.
+			if (_owner) {
+				_owner->inherit_priority(self->priority(), !_boosted);
+				_boosted = true;
+			}
+			_waiters.wait();
+		}
+		_locked = true;
+		_owner = self;
+	});
+}
+
+bool thr::Mutex::try_lock()
+{
+	return thr::with_irq_lock([this]() -> bool {
+		if (_locked) {
+			return false;
+		}
+		_locked = true;
+		_owner = sched::current();
+		return true;
+	});
+}
+
+void thr::Mutex::unlock()
+{
+	thr::with_irq_lock([this]() {
+		auto self = sched::current();
+		if (!_locked || _owner != self) {
+			panic("unlocking mutex that isn't owned");
+		}
+		_locked = false;
+		_owner = nullptr;
+		if (_boosted) {
+			_boosted = false;
+			self->restore_priority();
+		}
+		_waiters.notify_one();
+	});
+}
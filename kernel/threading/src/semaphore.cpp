@@ -0,0 +1,32 @@
+#include <threading/semaphore.hpp>
+
+#include <threading/with_lock.hpp>
+
+void thr::Semaphore::acquire()
+{
+	thr::with_irq_lock([this]() {
+		while (_count == 0) {
+			_waiters.wait();
+		}
+		--_count;
+	});
+}
+
+bool thr::Semaphore::try_acquire()
+{
+	return thr::with_irq_lock([this]() -> bool {
+		if (_count == 0) {
+			return false;
+		}
+		--_count;
+		return true;
+	});
+}
+
+void thr::Semaphore::release()
+{
+	thr::with_irq_lock([this]() {
+		++_count;
+		_waiters.notify_one();
+	});
+}
@@ -0,0 +1,79 @@
+#include <threading/spinlock.hpp>
+
+#include <bolgenos-ng/time.hpp>
+
+#if LOCK_STATS
+
+namespace {
+
+
+/// Head of list of named locks that were taken at least once.
+lib::atomic<thr::SpinLock*> registered_locks{nullptr};
+
+
+/// Convert TSC cycles to microseconds.
+unsigned long cycles_to_us(uint64_t cycles)
+{
+	uint64_t ns = time::cycles_to_ns(cycles);
+	x86::div64(ns, static_cast<uint32_t>(time::NSEC_PER_USEC));
+	return static_cast<unsigned long>(ns);
+}
+
+
+} // namespace
+
+
+void thr::SpinLock::account_acquire(uint64_t wait_start, bool contended)
+{
+	_acquired_at = x86::read_tsc();
+	++_stats.acquisitions;
+	if (contended) {
+		++_stats.contentions;
+		_stats.wait_cycles += _acquired_at - wait_start;
+	}
+
+	if (!_registered && _name) {
+		_registered = true;
+		SpinLock* head;
+		do {
+			head = registered_locks.load();
+			_next_registered = head;
+		} while (!registered_locks.compare_exchange(head, this));
+	}
+}
+
+
+void thr::SpinLock::account_release()
+{
+	const uint64_t held = x86::read_tsc() - _acquired_at;
+	_stats.hold_cycles += held;
+	if (held > _stats.max_hold_cycles) {
+		_stats.max_hold_cycles = held;
+	}
+}
+
+
+void thr::print_lock_stats(lib::ostream& out)
+{
+	out << "lock statistics (times in us):" << lib::endl;
+	for (SpinLock* lock = registered_locks.load(); lock;
+			lock = lock->_next_registered) {
+		const LockStats& stats = lock->_stats;
+		out << "\t" << lock->_name
+			<< ": acquisitions=" << stats.acquisitions
+			<< " contentions=" << stats.contentions
+			<< " wait=" << cycles_to_us(stats.wait_cycles)
+			<< " hold=" << cycles_to_us(stats.hold_cycles)
+			<< " max_hold=" << cycles_to_us(stats.max_hold_cycles)
+			<< lib::endl;
+	}
+}
+
+#else
+
+void thr::print_lock_stats(lib::ostream& out)
+{
+	out << "lock statistics are disabled" << lib::endl;
+}
+
+#endif
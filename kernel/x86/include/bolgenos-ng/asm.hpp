@@ -91,7 +91,8 @@ static inline void iowait() {
 * Constants that are used for Machine Specific Register indexing.
 */
 typedef enum {
-	msr_ia32_apic_base = 0x1b /*!< Start address of APIC mapped memory. */
+	msr_ia32_apic_base = 0x1b, /*!< Start address of APIC mapped memory. */
+	msr_ia32_tsc_deadline = 0x6e0 /*!< Deadline of APIC timer. */
 } msr_t;
 
 
@@ -276,6 +277,143 @@ void halt_cpu() {
 }
 
 
+/// \brief Enable interrupts and halt CPU.
+///
+/// Interrupts are enabled only after `hlt` is reached, so an interrupt that
+/// is pending at the moment of call wakes CPU up instead of being handled
+/// before it halts.
+inline
+void enable_and_halt_cpu() {
+	asm volatile("sti \n"
+		"hlt \n"
+		::: "memory");
+}
+
+
+/// \brief Save EFLAGS and disable interrupts.
+///
+/// \return Value of EFLAGS register before interrupts were disabled.
+inline
+uint32_t save_flags_and_cli() {
+	uint32_t flags;
+	asm volatile("pushfl \n"
+		"popl %0 \n"
+		"cli \n"
+		: "=r"(flags)
+		:
+		: "memory");
+	return flags;
+}
+
+
+/// \brief Restore EFLAGS.
+///
+/// Function restores EFLAGS register saved by \ref save_flags_and_cli, so
+/// interrupts are enabled only if they were enabled before.
+inline
+void restore_flags(uint32_t flags) {
+	asm volatile("pushl %0 \n"
+		"popfl \n"
+		:
+		: "g"(flags)
+		: "memory", "cc");
+}
+
+
+/// \brief Spin-wait hint.
+///
+/// Function should be called in the body of busy-wait loops.
+inline
+void cpu_relax() {
+	asm volatile("pause \n" ::: "memory");
+}
+
+
+/// \brief Read Time Stamp Counter.
+///
+/// Function returns current value of CPU Time Stamp Counter.
+inline
+uint64_t read_tsc() {
+	uint32_t low, high;
+	asm volatile("rdtsc \n": "=a"(low), "=d"(high));
+	return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+
+/// \brief Results of CPUID instruction.
+struct cpuid_t {
+	uint32_t eax;
+	uint32_t ebx;
+	uint32_t ecx;
+	uint32_t edx;
+};
+
+
+/// \brief Execute CPUID instruction.
+///
+/// \param leaf Requested CPUID leaf.
+/// \return Content of registers after executing CPUID.
+inline
+cpuid_t cpuid(uint32_t leaf) {
+	cpuid_t regs;
+	asm volatile("cpuid \n"
+		: "=a"(regs.eax), "=b"(regs.ebx), "=c"(regs.ecx), "=d"(regs.edx)
+		: "a"(leaf), "c"(0));
+	return regs;
+}
+
+
+/// \brief CPU features reported in leaf 1 of CPUID.
+enum cpuid_feature: uint32_t {
+	/// EDX: Time Stamp Counter.
+	edx_tsc			= 1 << 4,
+	/// EDX: On-chip APIC.
+	edx_apic		= 1 << 9,
+	/// ECX: TSC-deadline mode of APIC timer.
+	ecx_tsc_deadline	= 1 << 24,
+};
+
+
+/// \brief Divide 64-bit value by 32-bit one.
+///
+/// Kernel is linked without libgcc, so generic 64-bit division isn't
+/// available. The function does the division using two `divl` instructions.
+///
+/// \param[in,out] value Dividend. Replaced by quotient.
+/// \param divisor Divisor.
+/// \return Remainder.
+inline
+uint32_t div64(uint64_t& value, uint32_t divisor) {
+	uint32_t low = static_cast<uint32_t>(value);
+	uint32_t high = static_cast<uint32_t>(value >> 32);
+	uint32_t rem = 0;
+	if (high >= divisor) {
+		rem = high % divisor;
+		high = high / divisor;
+	} else {
+		rem = high;
+		high = 0;
+	}
+	asm("divl %2 \n": "+a"(low), "+d"(rem): "rm"(divisor));
+	value = (static_cast<uint64_t>(high) << 32) | low;
+	return rem;
+}
+
+
+/// \brief Multiply 64-bit value by 32-bit one and shift the product right.
+///
+/// \param value 64-bit multiplicand.
+/// \param mult 32-bit multiplier.
+/// \param shift Number of bits to shift the product (less than 32).
+/// \return (value * mult) >> shift.
+inline
+uint64_t mul_shr(uint64_t value, uint32_t mult, unsigned shift) {
+	const uint64_t low = static_cast<uint32_t>(value);
+	const uint64_t high = static_cast<uint32_t>(value >> 32);
+	return ((low * mult) >> shift) + ((high * mult) << (32 - shift));
+}
+
+
 inline
 static uint32_t lzcnt(uint32_t value)
 {
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic.hpp>
 #include <cstddef.hpp>
 #include <cstdint.hpp>
 #include <forward_list.hpp>
 #include <loggable.hpp>
 
 #include <bolgenos-ng/asm.hpp>
+#include <threading/spinlock.hpp>
+
+#include "config.h"
 
 namespace lib {
 	class ostream;
@@ -87,24 +91,106 @@ constexpr size_t NUMBER_OF_LINES = LAST_LINE + 1;
 
 
 
+/// Maximal number of handlers that share one vector.
+constexpr size_t MAX_SHARED_HANDLERS = 4;
+
+
+/// Routine that acknowledges interrupt; see \ref InterruptsManager::set_end_of_interrupt.
+using eoi_routine_t = void (irq_t vector);
+
+
+/// \brief Statistics of interrupt vector on one CPU.
+///
+/// Time is counted from the entry of dispatcher till the end of interrupt,
+/// so it includes interrupts nested into the handler.
+struct vector_stats_t {
+	/// Number of interrupts.
+	uint32_t count;
+	/// The longest handling.
+	uint32_t max_cycles;
+	/// Cumulative time of handling.
+	uint64_t cycles;
+};
+
+
 class InterruptsManager {
 public:
+	/// \brief Register handler of interrupt vector.
+	///
+	/// Up to \ref MAX_SHARED_HANDLERS handlers may share one vector; they
+	/// are called in order of registration till one of them handles the
+	/// interrupt.
 	void add_handler(irq_t vector, IRQHandler *handler);
 	void add_handler(exception_t exception, ExceptionHandler *handler);
 
+	/// \brief Unregister handler of interrupt vector.
+	///
+	/// Interrupt that is being handled on another CPU may still call
+	/// the handler, so the caller must make sure that the vector isn't
+	/// raised before the handler is destroyed.
+	void remove_handler(irq_t vector, IRQHandler *handler);
+
+	/// \brief Set routine that acknowledges interrupts.
+	///
+	/// Interrupt controller sets the routine on initialization, so that
+	/// the dispatcher calls it directly.
+	void set_end_of_interrupt(eoi_routine_t* routine);
+
+	/// \brief Print statistics of interrupts.
+	///
+	/// The function prints number of interrupts of every used vector on
+	/// every CPU together with average and maximal time of handling in
+	/// the format similar to /proc/interrupts of Linux.
+	void print_stats(lib::ostream& out) const;
+
 	static void init();
 	static InterruptsManager *instance();
+
 protected:
 	explicit InterruptsManager();
 
 	IRQHandler::status_t dispatch_interrupt(irq_t vector);
 	IRQHandler::status_t dispatch_exception(exception_t exception, stack_ptr_t frame_pointer);
 
+	/// Handler of exceptions and vectors with no bound entry.
 	static void handle_irq(irq_t vector, void *frame);
+
+	/// Entry of vector with one handler; is called directly by its stub.
+	static void single_handler_entry(irq_t vector);
+
+	/// Entry of vector with shared handlers.
+	static void shared_handlers_entry(irq_t vector);
+
 	static bool is_exception(irq_t vector);
+
 private:
-	lib::forward_list<IRQHandler *> _irq_handlers[NUMBER_OF_LINES];
+	/// Handlers of one vector.
+	struct vector_entry_t {
+		/// Number of registered handlers; is set after the handler.
+		lib::atomic<uint32_t> count;
+		IRQHandler* handlers[MAX_SHARED_HANDLERS];
+	};
+
+	/// \brief Account handling of interrupt.
+	///
+	/// \param vector Interrupt vector.
+	/// \param cycles Time of handling in TSC cycles.
+	void account(irq_t vector, uint64_t cycles);
+
+	/// \brief Acknowledge and account handled interrupt.
+	///
+	/// \param vector Interrupt vector.
+	/// \param status Result of handlers.
+	/// \param start TSC at the entry of the interrupt.
+	void finish_interrupt(irq_t vector, IRQHandler::status_t status,
+		uint64_t start);
+
+	vector_entry_t _irq_handlers[NUMBER_OF_LINES]{};
 	lib::forward_list<ExceptionHandler *> _exceptions_handlers[exception_t::max];
+	eoi_routine_t* _end_of_interrupt{nullptr};
+	/// Statistics are kept per CPU, so they are updated without locks.
+	vector_stats_t _stats[MAX_CPUS][NUMBER_OF_LINES]{};
+	thr::IrqSpinLock _handlers_lock{"irq_handlers"};
 
 	static InterruptsManager *_instance;
 };
@@ -113,6 +199,12 @@ private:
 bool is_enabled();
 
 
+/// \brief Check interrupt context.
+///
+/// \return true if the function is called by interrupt handler.
+bool in_interrupt();
+
+
 /// \brief Enable interrupts.
 ///
 /// Enable interrupts by setting Interrupt Flag for CPU.
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+
+#include "config.h"
+
+namespace lib {
+class ostream;
+}
+
+/// \brief Tracer of sections with disabled interrupts.
+///
+/// The tracer measures sections between \ref irq::disable and \ref irq::enable,
+/// and between \ref save_flags_and_cli and \ref restore_flags, with TSC and
+/// keeps the longest of them together with backtraces. Sections inside
+/// interrupt handlers aren't traced. The kernel has no preemption, so
+/// IRQ-off sections are the only source of scheduling latency that isn't
+/// caused by tasks themselves.
+///
+/// Functions do nothing if IRQ_LATENCY_TRACE option is disabled.
+namespace irq::trace {
+
+
+/// Number of the longest sections that are kept.
+constexpr size_t MAX_SECTIONS = 8;
+
+
+/// Maximal depth of backtraces of kept sections.
+constexpr size_t BACKTRACE_DEPTH = 8;
+
+
+/// \brief Start tracing.
+///
+/// Per-CPU data of the boot CPU must be loaded.
+void start();
+
+
+/// \brief Start of section; is called by \ref irq::disable.
+///
+/// \param caller Address the section is started from.
+void irqs_off(void* caller);
+
+
+/// End of section; is called by \ref irq::enable.
+void irqs_on();
+
+
+/// Print the longest sections.
+void print(lib::ostream& out);
+
+
+/// Interrupt flag in EFLAGS.
+constexpr uint32_t EFLAGS_IF = 1 << 9;
+
+
+/// \brief Save EFLAGS and disable interrupts.
+///
+/// The function is \ref x86::save_flags_and_cli that starts traced section
+/// if interrupts were enabled. The raw function is left for code that runs
+/// while per-CPU data can't be used.
+///
+/// \param caller Address the section is started from.
+inline uint32_t save_flags_and_cli(void* caller = __builtin_return_address(0))
+{
+	const uint32_t flags = x86::save_flags_and_cli();
+	if constexpr (IRQ_LATENCY_TRACE) {
+		if (flags & EFLAGS_IF) {
+			irqs_off(caller);
+		}
+	}
+	return flags;
+}
+
+
+/// \brief Restore EFLAGS saved by \ref save_flags_and_cli.
+///
+/// The traced section ends if interrupts are enabled back.
+inline void restore_flags(uint32_t flags)
+{
+	if constexpr (IRQ_LATENCY_TRACE) {
+		if (flags & EFLAGS_IF) {
+			irqs_on();
+		}
+	}
+	x86::restore_flags(flags);
+}
+
+
+} // namespace irq::trace
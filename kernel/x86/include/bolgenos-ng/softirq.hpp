@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic.hpp>
+
+namespace irq {
+
+
+/// \brief Deferred part of interrupt handler.
+///
+/// Interrupt handlers should do only urgent work like acknowledging device
+/// and reading its data, schedule tasklet for the rest of the work and return.
+/// Scheduled tasklets are run when the outermost interrupt handler finishes,
+/// with enabled interrupts but still on the interrupt stack, so they must not
+/// sleep or yield. Work that can sleep should be queued to work queue, see
+/// \ref sched::WorkQueue.
+class Tasklet {
+public:
+	using routine_type = void (void*);
+
+	Tasklet(routine_type* routine, void* arg)
+		: _routine{routine}, _arg{arg}
+	{
+	}
+
+	Tasklet(const Tasklet&) = delete;
+	Tasklet& operator =(const Tasklet&) = delete;
+
+
+	/// \brief Schedule tasklet.
+	///
+	/// The function may be called from any context. Tasklet that is
+	/// already scheduled won't be scheduled twice. If called outside of
+	/// interrupt handler, pending tasklets are run immediately.
+	void schedule();
+
+private:
+	routine_type* _routine;
+	void* _arg;
+	Tasklet* _next{nullptr};
+	bool _scheduled{false};
+
+	friend void run_tasklets();
+};
+
+
+/// \brief Run pending tasklets.
+///
+/// The function is called at exit of the outermost interrupt handler.
+void run_tasklets();
+
+
+} // namespace irq
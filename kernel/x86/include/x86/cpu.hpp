@@ -3,11 +3,16 @@
 #include "gdt.hpp"
 #include "idt.hpp"
 #include "eflags.hpp"
+#include "percpu.hpp"
+#include "tss.hpp"
+
+#include "config.h"
 
 namespace x86 {
 
 class Processor {
 public:
+	Processor();
 
 	static EFlags flags();
 
@@ -23,14 +28,26 @@ public:
 		return _idt;
 	}
 
-	void load_kernel_segments();
+	/// \brief Load segments.
+	///
+	/// The function loads GDT with kernel segments, task state segment and
+	/// segment of per-CPU data, and registers the CPU as online.
+	///
+	/// \param apic_id ID of local APIC of the CPU.
+	void load_kernel_segments(uint32_t apic_id = 0);
 	void load_interrupts_table();
 
+	/// Per-CPU data of the processor.
+	PerCpu& percpu() noexcept { return _percpu; }
+
 	[[gnu::noinline]]
 	static void switch_task_to(uint16_t segment_selector);
 private:
 	GDT _gdt{};
 	IDT _idt{};
+	TaskStateSegment _tss{};
+	PerCpu _percpu{};
+	alignas(16) lib::byte _irq_stack[IRQ_STACK_SIZE]{};
 };
 
 }
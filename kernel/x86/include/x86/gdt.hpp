@@ -17,6 +17,7 @@ enum class SegmentIndex: int
 	kernel_code = 1,
 	kernel_data = 2,
 	single_task = 3,
+	percpu = 4,
 };
 
 constexpr inline
@@ -34,6 +35,10 @@ constexpr uint16_t KERNEL_CODE_SELECTOR =
 constexpr uint16_t KERNEL_DATA_SELECTOR =
 	segment_selector(SegmentIndex::kernel_data, TableIndicator::GLOBAL, ProtectionRing::kernel);
 
+/// Segment of per-CPU data.
+constexpr uint16_t PERCPU_SELECTOR =
+	segment_selector(SegmentIndex::percpu, TableIndicator::GLOBAL, ProtectionRing::kernel);
+
 
 class GDT: Loggable("GDT") {
 public:
@@ -13,11 +13,35 @@ namespace x86 {
 
 using GlobalIrqHandler = void (irq::irq_t vector, irq::stack_ptr_t);
 
+/// \brief Entry of interrupt vector.
+///
+/// Entry is called directly by the interrupt stub of the vector; it must
+/// acknowledge the interrupt itself.
+using IrqEntry = void (irq::irq_t vector);
+
 class IDT {
 public:
 	IDT();
 	void reload_table();
 	static GlobalIrqHandler* set_global_handler(GlobalIrqHandler* handler);
+
+	/// \brief Bind entry to interrupt vector.
+	///
+	/// Vectors of exceptions always go through the global handler with full
+	/// frame. Other vectors go through it only until an entry is bound.
+	///
+	/// \param vector Vector of device interrupt or IPI.
+	/// \param entry Entry to be called or nullptr to use the global handler.
+	static void set_irq_entry(irq::irq_t vector, IrqEntry* entry);
+
+	/// \brief Set interrupt stack.
+	///
+	/// Interrupt handlers switch to the interrupt stack unless they
+	/// interrupt another handler that already runs on it.
+	static void set_irq_stack(lib::byte* stack_top);
+
+	/// Number of interrupt handlers that are being executed.
+	static uint32_t irq_nesting();
 private:
 	alignas(cpu_alignment) lib::array<Gate, irq::NUMBER_OF_LINES> _idt;
 	alignas(cpu_alignment) table_pointer _idt_pointer;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+
+#include "config.h"
+
+/// Multiprocessor configuration provided by firmware.
+namespace x86::mp {
+
+
+/// Maximal number of I/O APICs.
+constexpr size_t MAX_IOAPICS = 4;
+
+/// Maximal number of interrupt source overrides.
+constexpr size_t MAX_OVERRIDES = 16;
+
+
+/// Description of I/O APIC.
+struct ioapic_t {
+	uint32_t id;
+	/// Physical address of registers.
+	uint32_t address;
+	/// Number of the first global system interrupt handled by the I/O APIC.
+	uint32_t gsi_base;
+};
+
+
+/// \brief Interrupt source override.
+///
+/// ISA interrupt that isn't connected to the input of I/O APIC with the
+/// same number or has non-default polarity or trigger mode.
+struct override_t {
+	/// ISA IRQ.
+	uint8_t source;
+	/// Global system interrupt.
+	uint32_t gsi;
+	/// Polarity and trigger mode flags in MPS INTI format.
+	uint16_t flags;
+};
+
+
+/// Discovered configuration.
+struct config_t {
+	/// Source of configuration: "ACPI", "MP" or nullptr if nothing found.
+	const char* source;
+
+	/// Physical address of local APIC registers.
+	uint32_t lapic_address;
+
+	/// Local APIC IDs of usable CPUs.
+	uint32_t cpus[MAX_CPUS];
+	size_t cpus_count;
+
+	ioapic_t ioapics[MAX_IOAPICS];
+	size_t ioapics_count;
+
+	override_t overrides[MAX_OVERRIDES];
+	size_t overrides_count;
+};
+
+
+/// \brief Discover multiprocessor configuration.
+///
+/// The function looks for ACPI MADT table and falls back to Intel MP
+/// configuration table if ACPI isn't available. Result is cached.
+const config_t& discover();
+
+
+} // namespace x86::mp
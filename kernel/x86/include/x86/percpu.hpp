@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic.hpp>
+#include <cstddef.hpp>
+#include <cstdint.hpp>
+
+#include "config.h"
+
+namespace x86 {
+
+
+class Processor;
+
+
+/// \brief Per-CPU data.
+///
+/// Every CPU has its own instance of the structure. %fs segment of each CPU
+/// starts at its instance, so the data is accessed with no locks and no
+/// lookups; see \ref this_cpu.
+///
+/// \warning Layout of first fields is used by interrupt entry code.
+struct PerCpu {
+	/// Pointer to the structure itself; read by \ref this_cpu.
+	PerCpu* self;
+
+	/// Depth of nested interrupts.
+	uint32_t irq_nesting;
+
+	/// Top of interrupt stack.
+	lib::byte* irq_stack_top;
+
+	/// Sequential number of CPU; boot CPU has number 0.
+	uint32_t index;
+
+	/// ID of local APIC.
+	uint32_t apic_id;
+
+	/// Processor that owns the structure.
+	Processor* processor;
+
+	/// Scheduler of the CPU; is managed by scheduler.
+	void* scheduler;
+
+	/// CPU has to look for new tasks to run.
+	lib::atomic<bool> need_resched;
+};
+
+
+/// \brief Get data of current CPU.
+///
+/// \warning Result is valid only till task is switched, since task may be
+///	continued on another CPU.
+inline PerCpu* this_cpu()
+{
+	PerCpu* cpu;
+	asm volatile("movl %%fs:0, %0 \n" : "=r"(cpu));
+	return cpu;
+}
+
+
+/// \brief Get data of CPU by its number.
+///
+/// \return nullptr if CPU isn't online.
+PerCpu* cpu_by_index(uint32_t index);
+
+
+/// Number of online CPUs.
+uint32_t online_cpus();
+
+
+/// \brief Register CPU as online.
+///
+/// \return Sequential number of the CPU.
+uint32_t register_cpu(PerCpu* cpu);
+
+
+} // namespace x86
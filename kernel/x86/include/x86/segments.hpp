@@ -10,7 +10,4 @@ extern const MemorySegmentDescriptor null;
 extern const MemorySegmentDescriptor kernel_code;
 extern const MemorySegmentDescriptor kernel_data;
 
-extern const TaskStateSegment single_task;
-extern const TaskStateSegmentDescriptor single_task_descriptor;
-
 }
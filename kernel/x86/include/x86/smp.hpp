@@ -0,0 +1,23 @@
+#pragma once
+
+/// Symmetric multiprocessing.
+namespace x86::smp {
+
+
+/**
+* \brief Start application processors.
+*
+* The function finds CPUs in multiprocessor configuration provided by
+* firmware, starts them with INIT and start-up IPIs and runs scheduler on
+* every started CPU. From this moment critical sections of
+* \ref thr::RecursiveIrqLocker are serialized by the kernel lock.
+*
+* Does nothing if SMP option is off or the system has only one CPU.
+*
+* \warning The function must be called from a task, since it sleeps while
+*	CPUs are started.
+*/
+void init();
+
+
+} // namespace x86::smp
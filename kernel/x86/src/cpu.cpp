@@ -1,24 +1,73 @@
 #include <x86/cpu.hpp>
 
+#include <bolgenos-ng/error.h>
 #include <x86/segments.hpp>
 #include <threading/threading.hpp>
 #include <mutex.hpp>
 
-void x86::Processor::load_kernel_segments()
+namespace {
+
+
+/// Per-CPU data of online CPUs.
+x86::PerCpu* cpus[MAX_CPUS]{};
+
+/// Number of online CPUs.
+lib::atomic<uint32_t> cpus_count{0};
+
+
+} // namespace
+
+
+x86::Processor::Processor() = default;
+
+
+void x86::Processor::load_kernel_segments(uint32_t apic_id)
 {
-	thr::with_lock<thr::RecursiveIrqLocker>([&]{
-		_gdt.push_back(segments::null);
-		_gdt.push_back(segments::kernel_code);
-		_gdt.push_back(segments::kernel_data);
-		_gdt.push_back(segments::single_task_descriptor);
-		_gdt.reload_table();
-		reload_segment_registers();
-		init_task_register();
-	});
+	_percpu.self = &_percpu;
+	_percpu.processor = this;
+	_percpu.apic_id = apic_id;
+
+	const TaskStateSegmentDescriptor tss_descriptor{
+		reinterpret_cast<lib::uintptr_t>(&_tss),
+		sizeof(_tss) - 1,
+		false,
+		ProtectionRing::kernel,
+		Present::present,
+		Granularity::bytes
+	};
+
+	const MemorySegmentDescriptor percpu_segment{
+		reinterpret_cast<lib::uintptr_t>(&_percpu),
+		sizeof(_percpu) - 1,
+		static_cast<SegmentType>(SegmentType::data | SegmentType::data_write),
+		System::code_or_data,
+		ProtectionRing::kernel,
+		Present::present,
+		Long::other,
+		OperationSize::db32_bit,
+		Granularity::bytes
+	};
+
+	// Kernel lock can't be used here: it identifies CPUs by per-CPU
+	// segment that is being changed.
+	const uint32_t flags = save_flags_and_cli();
+	_gdt.push_back(segments::null);
+	_gdt.push_back(segments::kernel_code);
+	_gdt.push_back(segments::kernel_data);
+	_gdt.push_back(tss_descriptor);
+	_gdt.push_back(percpu_segment);
+	_gdt.reload_table();
+	reload_segment_registers();
+	asm volatile("movw %w0, %%fs \n" :: "r"(PERCPU_SELECTOR) : "memory");
+	init_task_register();
+	restore_flags(flags);
+
+	_percpu.index = register_cpu(&_percpu);
 }
 
 void x86::Processor::load_interrupts_table()
 {
+	IDT::set_irq_stack(_irq_stack + sizeof(_irq_stack));
 	_idt.reload_table();
 }
 
@@ -43,3 +92,22 @@ void x86::Processor::switch_task_to(uint16_t segment_selector)
 	"1:" :: "m"(dest));
 }
 
+x86::PerCpu* x86::cpu_by_index(uint32_t index)
+{
+	return index < MAX_CPUS ? cpus[index] : nullptr;
+}
+
+uint32_t x86::online_cpus()
+{
+	return cpus_count.load();
+}
+
+uint32_t x86::register_cpu(PerCpu* cpu)
+{
+	const uint32_t index = cpus_count.fetch_add(1);
+	if (index >= MAX_CPUS) {
+		panic("too many CPUs");
+	}
+	cpus[index] = cpu;
+	return index;
+}
@@ -2,32 +2,114 @@
 
 #include <atomic.hpp>
 
+#include <bolgenos-ng/error.h>
+
+#include <x86/percpu.hpp>
+
 using namespace lib;
 using namespace x86;
 
 namespace {
 
+/// \brief Exception entry.
+///
+/// The outermost interrupt switches to the interrupt stack of the current
+/// CPU, so frames of interrupt handlers aren't put on task stacks. Nesting
+/// depth and the stack are taken from per-CPU data addressed by %fs.
+/// Original stack pointer is kept in EBX that is restored by `popal`.
+///
+/// Exception handlers get the full frame that is dumped on faults.
 template<int N>
 [[gnu::aligned(16)]]
-void _asm_irq_handler()
+void _asm_exception_handler()
 {
 	asm(
 	"pushal\n"
-	"push %%esp\n"
+	"mov %%esp, %%ebx\n"
+	"incl %%fs:%c1\n"
+	"cmpl $1, %%fs:%c1\n"
+	"jne 1f\n"
+	"mov %%fs:%c2, %%esp\n"
+	"1:\n"
+	"push %%ebx\n"
 	"pushl %0\n"
 	"call c_irq_dispatcher_\n"
-	"add $8, %%esp\n"
+	"mov %%ebx, %%esp\n"
+	"decl %%fs:%c1\n"
 	"popal\n"
 	"iret\n"
 	:
-	: "i"(N)
+	: "i"(N), "i"(__builtin_offsetof(PerCpu, irq_nesting)),
+		"i"(__builtin_offsetof(PerCpu, irq_stack_top))
 	);
 }
 
+IrqEntry default_irq_entry;
+
+template<class I, I ... Is>
+constexpr array<IrqEntry*, sizeof...(Is)> make_irq_entries(integer_sequence<I, Is...>)
+{
+	return {((void) Is, &default_irq_entry)...};
+}
+
+/// \brief Entries of device interrupts and IPIs.
+///
+/// Entry of every vector is called directly by its interrupt stub.
+constinit array<IrqEntry*, irq::NUMBER_OF_LINES> irq_entries
+	= make_irq_entries(make_index_sequence<irq::NUMBER_OF_LINES>());
+
+/// \brief Interrupt entry.
+///
+/// Device interrupts and IPIs don't need the frame of interrupted code, so
+/// only registers that aren't preserved by C functions are saved, and entry
+/// bound to the vector is called with no further dispatching. Original stack
+/// pointer is kept on the interrupt stack.
+template<int N>
+[[gnu::aligned(16)]]
+void _asm_irq_handler()
+{
+	asm(
+	"push %%eax\n"
+	"push %%ecx\n"
+	"push %%edx\n"
+	"mov %%esp, %%eax\n"
+	"incl %%fs:%c1\n"
+	"cmpl $1, %%fs:%c1\n"
+	"jne 1f\n"
+	"mov %%fs:%c2, %%esp\n"
+	"1:\n"
+	"push %%eax\n"
+	"pushl %0\n"
+	"cld\n"
+	"call *%P3\n"
+	"add $4, %%esp\n"
+	"pop %%esp\n"
+	"decl %%fs:%c1\n"
+	"pop %%edx\n"
+	"pop %%ecx\n"
+	"pop %%eax\n"
+	"iret\n"
+	:
+	: "i"(N), "i"(__builtin_offsetof(PerCpu, irq_nesting)),
+		"i"(__builtin_offsetof(PerCpu, irq_stack_top)),
+		"i"(&irq_entries[N])
+	);
+}
+
+template<int N>
+constexpr Gate make_gate()
+{
+	if constexpr (N < irq::exception_t::max) {
+		return Gate::interrupt_gate(&_asm_exception_handler<N>);
+	} else {
+		return Gate::interrupt_gate(&_asm_irq_handler<N>);
+	}
+}
+
 template<class I, I ... Is>
 auto make_gates(integer_sequence<I, Is...>)
 {
-	return array{Gate::interrupt_gate(&_asm_irq_handler<Is>)...};
+	return array{make_gate<Is>()...};
 }
 
 template<size_t N>
@@ -51,6 +133,17 @@ void c_irq_dispatcher_(irq::irq_t vector, void* frame) {
 	}
 }
 
+namespace {
+
+/// Entry of interrupts that have no bound entry; goes through global handler.
+void default_irq_entry(irq::irq_t vector)
+{
+	c_irq_dispatcher_(vector, nullptr);
+}
+
+} // namespace
+
+
 lib::ostream& x86::operator<<(lib::ostream& out, const Gate& gate) {
 	switch (gate.type()) {
 	case GateType::task:
@@ -74,6 +167,27 @@ void IDT::reload_table()
 	asm volatile("lidt %0"::"m" (_idt_pointer));
 }
 
+void IDT::set_irq_stack(lib::byte* stack_top)
+{
+	this_cpu()->irq_stack_top = stack_top;
+}
+
+uint32_t IDT::irq_nesting()
+{
+	return this_cpu()->irq_nesting;
+}
+
 GlobalIrqHandler* IDT::set_global_handler(GlobalIrqHandler *handler) {
 	return global_handler.exchange(handler);
 }
+
+void IDT::set_irq_entry(irq::irq_t vector, IrqEntry* entry)
+{
+	if (vector < irq::exception_t::max) {
+		panic("exceptions can't have interrupt entries");
+	}
+	// Aligned pointer is written at once, so the stub calls either the
+	// old entry or the new one.
+	__atomic_store_n(&irq_entries[vector], entry ? entry : &default_irq_entry,
+		__ATOMIC_RELEASE);
+}
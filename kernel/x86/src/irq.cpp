@@ -1,14 +1,18 @@
 #include <bolgenos-ng/irq.hpp>
 
 #include <algorithm.hpp>
-#include <atomic.hpp>
+#include <format.hpp>
 
 #include <bolgenos-ng/error.h>
 #include <bolgenos-ng/interrupt_controller.hpp>
+#include <bolgenos-ng/irq_trace.hpp>
+#include <bolgenos-ng/softirq.hpp>
 
 #include <ext/scoped_format_guard.hpp>
+#include <threading/with_lock.hpp>
 
 #include <x86/cpu.hpp>
+#include <x86/percpu.hpp>
 #include <logger.hpp>
 
 #include "traps.hpp"
@@ -35,13 +39,57 @@ irq::InterruptsManager *irq::InterruptsManager::instance()
 
 void irq::InterruptsManager::add_handler(irq_t vector, IRQHandler *handler)
 {
-	auto& handlers_list = _irq_handlers[vector];
-	if (handlers_list.push_front(handler) == handlers_list.end()) {
-		panic("failed to register interrupt handler");
+	auto& entry = _irq_handlers[vector];
+	thr::with_lock(_handlers_lock, [&]() {
+		const uint32_t count = entry.count.load(lib::memory_order_relaxed);
+		if (count == MAX_SHARED_HANDLERS) {
+			panic("too many handlers of interrupt vector");
+		}
+		entry.handlers[count] = handler;
+		// Dispatcher may run on another CPU; it reads the count first.
+		entry.count.store(count + 1, lib::memory_order_release);
+	});
+
+	if (!is_exception(vector)) {
+		x86::IDT::set_irq_entry(vector, entry.count.load() == 1
+			? single_handler_entry : shared_handlers_entry);
 	}
 }
 
 
+void irq::InterruptsManager::remove_handler(irq_t vector, IRQHandler *handler)
+{
+	auto& entry = _irq_handlers[vector];
+	thr::with_lock(_handlers_lock, [&]() {
+		const uint32_t count = entry.count.load(lib::memory_order_relaxed);
+		const auto end = entry.handlers + count;
+		const auto found = lib::find_if(entry.handlers, end,
+			[handler](IRQHandler* registered) {
+				return registered == handler;
+			});
+		if (found == end) {
+			panic("removing handler that isn't registered");
+		}
+
+		if (count == 1) {
+			x86::IDT::set_irq_entry(vector, nullptr);
+		} else if (count == 2) {
+			x86::IDT::set_irq_entry(vector, single_handler_entry);
+		}
+		// Dispatcher may still read the old count, so the remaining
+		// handlers are shifted before the count is decreased.
+		lib::copy(found + 1, end, found);
+		entry.count.store(count - 1, lib::memory_order_release);
+	});
+}
+
+
+void irq::InterruptsManager::set_end_of_interrupt(eoi_routine_t* routine)
+{
+	_end_of_interrupt = routine;
+}
+
+
 void irq::InterruptsManager::add_handler(exception_t exception, ExceptionHandler *handler)
 {
 	auto& handlers_list = _exceptions_handlers[exception];
@@ -77,16 +125,89 @@ irq::IRQHandler::status_t irq::InterruptsManager::dispatch_exception(exception_t
 
 irq::IRQHandler::status_t irq::InterruptsManager::dispatch_interrupt(irq_t vector)
 {
-	auto& handlers = _irq_handlers[vector];
-	auto used_handler = lib::find_if(handlers.begin(), handlers.end(),
-		[vector] (irq::IRQHandler* handler) -> bool {
-			return handler->handle_irq(vector) == irq::IRQHandler::status_t::HANDLED;
-	});
-	if (used_handler == handlers.end()) {
-		return irq::IRQHandler::status_t::NONE;
+	const auto& entry = _irq_handlers[vector];
+	const uint32_t count = entry.count.load(lib::memory_order_acquire);
+	if (count == 1) [[likely]] {
+		return entry.handlers[0]->handle_irq(vector);
 	}
-	return irq::IRQHandler::status_t::HANDLED;
 
+	for (uint32_t i = 0; i < count; ++i) {
+		if (entry.handlers[i]->handle_irq(vector) == irq::IRQHandler::status_t::HANDLED) {
+			return irq::IRQHandler::status_t::HANDLED;
+		}
+	}
+	return irq::IRQHandler::status_t::NONE;
+}
+
+
+void irq::InterruptsManager::account(irq_t vector, uint64_t cycles)
+{
+	auto& stats = _stats[x86::this_cpu()->index][vector];
+	++stats.count;
+	stats.cycles += cycles;
+	if (cycles > stats.max_cycles) {
+		stats.max_cycles = cycles > ~static_cast<uint32_t>(0)
+			? ~static_cast<uint32_t>(0)
+			: static_cast<uint32_t>(cycles);
+	}
+}
+
+
+void irq::InterruptsManager::print_stats(lib::ostream& out) const
+{
+	lib::ScopedFormatGuard format_guard(out);
+	const uint32_t cpus = x86::online_cpus();
+
+	out << lib::setfill(' ') << "vector";
+	for (uint32_t cpu = 0; cpu < cpus; ++cpu) {
+		out << lib::setw(8) << "CPU" << lib::setw(0) << lib::dec << cpu;
+	}
+	out << lib::setw(14) << "avg cycles" << lib::setw(14) << "max cycles"
+		<< lib::setw(0) << lib::endl;
+
+	for (size_t vector = 0; vector < NUMBER_OF_LINES; ++vector) {
+		uint32_t count = 0;
+		uint32_t max_cycles = 0;
+		uint64_t cycles = 0;
+		for (uint32_t cpu = 0; cpu < cpus; ++cpu) {
+			const auto& stats = _stats[cpu][vector];
+			count += stats.count;
+			cycles += stats.cycles;
+			max_cycles = lib::max(max_cycles, stats.max_cycles);
+		}
+		if (!count) {
+			continue;
+		}
+		x86::div64(cycles, count);
+
+		out << "  0x" << lib::hex << lib::setw(2) << lib::setfill('0')
+			<< vector << lib::setfill(' ') << lib::dec;
+		for (uint32_t cpu = 0; cpu < cpus; ++cpu) {
+			out << lib::setw(9) << _stats[cpu][vector].count;
+		}
+		out << lib::setw(14) << static_cast<uint32_t>(cycles)
+			<< lib::setw(14) << max_cycles << lib::setw(0) << lib::endl;
+	}
+}
+
+
+void irq::InterruptsManager::finish_interrupt(irq_t vector,
+		IRQHandler::status_t status, uint64_t start)
+{
+	if (status != irq::IRQHandler::status_t::HANDLED) [[unlikely]] {
+		LOG_CRIT << "Unhandled IRQ" << vector << lib::endl;
+	}
+
+	if (_end_of_interrupt) [[likely]] {
+		_end_of_interrupt(vector);
+	} else {
+		devices::InterruptController::instance()->end_of_interrupt(vector);
+	}
+	account(vector, x86::read_tsc() - start);
+
+	if (x86::IDT::irq_nesting() == 1) {
+		run_tasklets();
+	}
 }
 
 
@@ -94,40 +215,46 @@ void irq::InterruptsManager::handle_irq(irq_t vector, void *frame)
 {
 	irq::IRQHandler::status_t status;
 
-	auto manager = irq::InterruptsManager::instance();
+	const uint64_t start = x86::read_tsc();
+	auto manager = _instance;
 	if (is_exception(vector)) {
 		status = manager->dispatch_exception(static_cast<exception_t>(vector), frame);
 	} else {
 		status = manager->dispatch_interrupt(vector);
 	}
 
-	if (status != irq::IRQHandler::status_t::HANDLED) {
-		LOG_CRIT << "Unhandled IRQ" << vector << lib::endl;
-	}
+	manager->finish_interrupt(vector, status, start);
+}
+
 
-	devices::InterruptController::instance()->end_of_interrupt(vector);
+void irq::InterruptsManager::single_handler_entry(irq_t vector)
+{
+	const uint64_t start = x86::read_tsc();
+	auto manager = _instance;
+	const auto status = manager->_irq_handlers[vector].handlers[0]->handle_irq(vector);
+	manager->finish_interrupt(vector, status, start);
+}
+
+
+void irq::InterruptsManager::shared_handlers_entry(irq_t vector)
+{
+	const uint64_t start = x86::read_tsc();
+	auto manager = _instance;
+	const auto status = manager->dispatch_interrupt(vector);
+	manager->finish_interrupt(vector, status, start);
 }
 
 
 lib::ostream& irq::operator <<(lib::ostream& out,
 		const irq::registers_dump_t& regs)
 {
-	lib::ScopedFormatGuard format_guard(out);
-
-	out	<< lib::setw(0) << lib::hex << lib::setfill(' ');
-	out	<< " eax = "
-			<< lib::setw(8) << lib::setfill('0')
-				<< regs.eax
-			<< lib::setfill(' ') << lib::setw(0)
-		<< ' '
-		<< " ebx = " << lib::setw(8) << regs.ebx << lib::setw(0) << ' '
-		<< " ecx = " << lib::setw(8) << regs.ecx << lib::setw(0) << ' '
-		<< " edx = " << lib::setw(8) << regs.edx << lib::setw(0) << ' '
-		<< lib::endl
-		<< " esi = " << lib::setw(8) << regs.esi << lib::setw(0) << ' '
-		<< " edi = " << lib::setw(8) << regs.edi << lib::setw(0) << ' '
-		<< " ebp = " << lib::setw(8) << regs.ebp << lib::setw(0) << ' '
-		<< " esp = " << lib::setw(8) << regs.esp << lib::setw(0) << ' ';
+	lib::format_to(out,
+		" eax = {:08x}  ebx = {:08x}  ecx = {:08x}  edx = {:08x} ",
+		regs.eax, regs.ebx, regs.ecx, regs.edx);
+	out << lib::endl;
+	lib::format_to(out,
+		" esi = {:08x}  edi = {:08x}  ebp = {:08x}  esp = {:08x} ",
+		regs.esi, regs.edi, regs.ebp, regs.esp);
 
 	return out;
 }
@@ -136,61 +263,43 @@ lib::ostream& irq::operator <<(lib::ostream& out,
 lib::ostream& irq::operator <<(lib::ostream& out,
 		const irq::execution_info_dump_t& exe)
 {
-	lib::ScopedFormatGuard format_guard(out);
-
-	out	<< lib::setw(0) << lib::hex
-		<< "eflg = " << lib::setw(8) << exe.eflags << lib::setw(0) << ' '
-		<< "  cs = " << lib::setw(8) << exe.cs << lib::setw(0) << ' '
-		<< " eip = " << lib::setw(8) << exe.eip << lib::setw(0);
-
-	return out;
+	return lib::format_to(out, "eflg = {:08x}   cs = {:08x}  eip = {:08x}",
+		exe.eflags, exe.cs, exe.eip);
 }
 
 
 lib::ostream& irq::operator <<(lib::ostream& out,
 		const irq::int_frame_error_t& frame)
 {
-	lib::ScopedFormatGuard format_guard(out);
-
-	out	<< lib::hex
-		<< lib::setw(0) << " err = "
-		<< lib::setw(8) << frame.error_code
-		<< lib::endl
-		<< frame.exe << lib::endl
-		<< frame.regs;
-
-	return out;
+	lib::format_to(out, " err = {:08x}", frame.error_code);
+	return out << lib::endl << frame.exe << lib::endl << frame.regs;
 }
 
 
 lib::ostream& irq::operator <<(lib::ostream& out,
 		const irq::int_frame_noerror_t& frame)
 {
-	lib::ScopedFormatGuard format_guard(out);
-
-	out	<< lib::setw(0) << lib::hex
-		<< frame.exe << lib::endl
-		<< frame.regs;
-
-	return out;
+	return out << frame.exe << lib::endl << frame.regs;
 }
 
-static lib::atomic<bool> interrupts_enabled{false};
-
 bool irq::is_enabled() {
-	auto flags = x86::Processor::flags();
-	if (flags.interrupts != interrupts_enabled.load()) {
-		panic("irq enabled state not synced");
-	}
-	return interrupts_enabled.load();
+	return x86::Processor::flags().interrupts;
+}
+
+bool irq::in_interrupt() {
+	return x86::IDT::irq_nesting() != 0;
 }
 
 void irq::enable(bool debug) {
 	if (debug) {
 		LOG_INFO << "enabling interrupts" << lib::endl;
 	}
-	interrupts_enabled.store(true);
-	asm volatile ("sti\n");
+	if constexpr (IRQ_LATENCY_TRACE) {
+		if (!is_enabled()) {
+			trace::irqs_on();
+		}
+	}
+	asm volatile ("sti\n" ::: "memory");
 }
 
 bool irq::disable(bool debug) {
@@ -198,9 +307,17 @@ bool irq::disable(bool debug) {
 		LOG_INFO << "disabling interrupts" << lib::endl;
 	}
 
-	asm volatile ("cli\n");
+	// Interrupt handlers run with cleared IF, so the state is taken from
+	// EFLAGS rather than from a software copy.
+	const bool was_enabled = is_enabled();
+	asm volatile ("cli\n" ::: "memory");
+	if constexpr (IRQ_LATENCY_TRACE) {
+		if (was_enabled) {
+			trace::irqs_off(__builtin_return_address(0));
+		}
+	}
 
-	return interrupts_enabled.exchange(false);
+	return was_enabled;
 }
 
 // Compile-time guards
@@ -0,0 +1,190 @@
+#include <bolgenos-ng/irq_trace.hpp>
+
+#include <atomic.hpp>
+#include <execinfo.hpp>
+#include <mutex.hpp>
+#include <ostream.hpp>
+
+#include <bolgenos-ng/asm.hpp>
+#include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/time.hpp>
+#include <threading/spinlock.hpp>
+#include <x86/percpu.hpp>
+
+#include "config.h"
+
+
+#if IRQ_LATENCY_TRACE
+
+namespace {
+
+
+/// Traced section.
+struct section_t {
+	/// Length in TSC cycles.
+	uint64_t cycles;
+	/// Address the section is started from.
+	void* caller;
+	/// Index of CPU.
+	uint32_t cpu;
+	/// Backtrace at the end of the section.
+	void* backtrace[irq::trace::BACKTRACE_DEPTH];
+	size_t depth;
+};
+
+
+/// Section that is being run by CPU.
+struct cpu_state_t {
+	/// TSC at the start of section or 0 if interrupts are enabled.
+	uint64_t since;
+	void* caller;
+};
+
+
+lib::atomic<bool> tracing{false};
+
+cpu_state_t cpu_states[MAX_CPUS]{};
+
+/// The longest sections in no particular order.
+section_t sections[irq::trace::MAX_SECTIONS]{};
+
+/// The shortest kept section; shorter ones aren't recorded.
+lib::atomic<uint32_t> threshold{0};
+
+/// Lock of \ref sections; is taken with disabled interrupts.
+thr::SpinLock sections_lock{"irq_trace"};
+
+
+void record(uint64_t cycles, void* caller, uint32_t cpu)
+{
+	void* backtrace[irq::trace::BACKTRACE_DEPTH];
+	const size_t depth = execinfo::capture_backtrace(backtrace,
+		irq::trace::BACKTRACE_DEPTH);
+
+	lib::lock_guard guard{sections_lock};
+	section_t* shortest = &sections[0];
+	for (auto& section: sections) {
+		if (section.cycles < shortest->cycles) {
+			shortest = &section;
+		}
+	}
+	if (cycles <= shortest->cycles) {
+		return;
+	}
+
+	shortest->cycles = cycles;
+	shortest->caller = caller;
+	shortest->cpu = cpu;
+	shortest->depth = depth;
+	for (size_t i = 0; i < depth; ++i) {
+		shortest->backtrace[i] = backtrace[i];
+	}
+
+	uint64_t new_threshold = ~static_cast<uint64_t>(0);
+	for (const auto& section: sections) {
+		if (section.cycles < new_threshold) {
+			new_threshold = section.cycles;
+		}
+	}
+	threshold.store(new_threshold > ~static_cast<uint32_t>(0)
+		? ~static_cast<uint32_t>(0)
+		: static_cast<uint32_t>(new_threshold),
+		lib::memory_order_relaxed);
+}
+
+
+} // namespace
+
+
+void irq::trace::start()
+{
+	tracing.store(true);
+}
+
+
+void irq::trace::irqs_off(void* caller)
+{
+	if (!tracing.load(lib::memory_order_relaxed)) {
+		return;
+	}
+	auto& state = cpu_states[x86::this_cpu()->index];
+	state.since = x86::read_tsc();
+	state.caller = caller;
+}
+
+
+void irq::trace::irqs_on()
+{
+	if (!tracing.load(lib::memory_order_relaxed) || irq::in_interrupt()) {
+		return;
+	}
+	const uint32_t cpu = x86::this_cpu()->index;
+	auto& state = cpu_states[cpu];
+	if (!state.since) {
+		return;
+	}
+	const uint64_t cycles = x86::read_tsc() - state.since;
+	state.since = 0;
+	if (cycles > threshold.load(lib::memory_order_relaxed)) {
+		record(cycles, state.caller, cpu);
+	}
+}
+
+
+void irq::trace::print(lib::ostream& out)
+{
+	section_t copy[MAX_SECTIONS];
+	const uint32_t flags = x86::save_flags_and_cli();
+	sections_lock.lock();
+	for (size_t i = 0; i < MAX_SECTIONS; ++i) {
+		copy[i] = sections[i];
+	}
+	sections_lock.unlock();
+	x86::restore_flags(flags);
+
+	out << "the longest sections with disabled interrupts:" << lib::endl;
+	for (size_t printed = 0; printed < MAX_SECTIONS; ++printed) {
+		section_t* longest = nullptr;
+		for (auto& section: copy) {
+			if (section.cycles && (!longest || section.cycles > longest->cycles)) {
+				longest = &section;
+			}
+		}
+		if (!longest) {
+			break;
+		}
+
+		uint64_t us = time::cycles_to_ns(longest->cycles);
+		x86::div64(us, time::NSEC_PER_USEC);
+		out << lib::dec << static_cast<uint32_t>(us) << " us on CPU #"
+			<< longest->cpu << ", disabled at " << longest->caller
+			<< ", enabled at:" << lib::endl;
+		execinfo::show_backtrace(out, longest->backtrace, longest->depth);
+		longest->cycles = 0;
+	}
+}
+
+#else
+
+void irq::trace::start()
+{
+}
+
+
+void irq::trace::irqs_off(void*)
+{
+}
+
+
+void irq::trace::irqs_on()
+{
+}
+
+
+void irq::trace::print(lib::ostream& out)
+{
+	out << "tracing of sections with disabled interrupts is disabled"
+		<< lib::endl;
+}
+
+#endif
@@ -0,0 +1,494 @@
+#include <x86/mp_config.hpp>
+
+#include <cstring.hpp>
+
+#include <logger.hpp>
+
+LOCAL_LOGGER("mp", lib::LogLevel::INFO);
+
+
+namespace {
+
+
+using x86::mp::config_t;
+
+
+/// Address of segment of extended BIOS data area.
+constexpr lib::uintptr_t EBDA_SEGMENT_PTR = 0x40e;
+
+/// Address of size of base memory in kB.
+constexpr lib::uintptr_t BASE_MEMORY_SIZE_PTR = 0x413;
+
+/// BIOS read-only memory area.
+constexpr lib::uintptr_t BIOS_ROM_BEGIN = 0xe0000;
+constexpr lib::uintptr_t BIOS_ROM_END = 0x100000;
+
+
+/// Number of inputs of I/O APIC that is assumed if firmware doesn't tell.
+constexpr uint32_t DEFAULT_IOAPIC_INPUTS = 24;
+
+
+config_t config{};
+bool discovered = false;
+
+
+template<typename T>
+const T* physical(lib::uintptr_t address)
+{
+	// Address is hidden from compiler that considers the lowest page to
+	// be out of any object, though it keeps BIOS data area.
+	asm("" : "+r"(address));
+	return reinterpret_cast<const T*>(address);
+}
+
+
+bool checksum_ok(const void* data, size_t length)
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	uint8_t sum = 0;
+	for (size_t i = 0; i != length; ++i) {
+		sum += bytes[i];
+	}
+	return sum == 0;
+}
+
+
+/// \brief Find structure by signature.
+///
+/// Structures are looked for on 16-bytes boundaries.
+///
+/// \return Address of structure or 0 if nothing is found.
+lib::uintptr_t find_signature(lib::uintptr_t begin, lib::uintptr_t end,
+	const char* signature, size_t length, size_t checked_length)
+{
+	for (auto address = begin; address + checked_length <= end; address += 16) {
+		if (memcmp(physical<char>(address), signature, length) == 0
+				&& checksum_ok(physical<void>(address), checked_length)) {
+			return address;
+		}
+	}
+	return 0;
+}
+
+
+/// \brief Find structure in standard BIOS areas.
+///
+/// Areas are the first kB of EBDA, the last kB of base memory and BIOS ROM.
+lib::uintptr_t find_in_bios_areas(const char* signature, size_t length,
+	size_t checked_length)
+{
+	const lib::uintptr_t ebda = static_cast<lib::uintptr_t>(
+		*physical<uint16_t>(EBDA_SEGMENT_PTR)) << 4;
+	if (ebda) {
+		auto found = find_signature(ebda, ebda + 1024, signature, length,
+			checked_length);
+		if (found) {
+			return found;
+		}
+	}
+
+	const lib::uintptr_t base_end = static_cast<lib::uintptr_t>(
+		*physical<uint16_t>(BASE_MEMORY_SIZE_PTR)) * 1024;
+	if (base_end >= 1024) {
+		auto found = find_signature(base_end - 1024, base_end, signature,
+			length, checked_length);
+		if (found) {
+			return found;
+		}
+	}
+
+	return find_signature(BIOS_ROM_BEGIN, BIOS_ROM_END, signature, length,
+		checked_length);
+}
+
+
+void add_cpu(uint32_t apic_id)
+{
+	if (config.cpus_count == MAX_CPUS) {
+		LOG_WARN << "CPU #" << apic_id << " is ignored: too many CPUs"
+			<< lib::endl;
+		return;
+	}
+	config.cpus[config.cpus_count++] = apic_id;
+}
+
+
+void add_ioapic(uint32_t id, uint32_t address, uint32_t gsi_base)
+{
+	if (config.ioapics_count == x86::mp::MAX_IOAPICS) {
+		LOG_WARN << "I/O APIC #" << id << " is ignored" << lib::endl;
+		return;
+	}
+	config.ioapics[config.ioapics_count++] = {id, address, gsi_base};
+}
+
+
+void add_override(uint8_t source, uint32_t gsi, uint16_t flags)
+{
+	if (config.overrides_count == x86::mp::MAX_OVERRIDES) {
+		LOG_WARN << "override of IRQ " << source << " is ignored"
+			<< lib::endl;
+		return;
+	}
+	config.overrides[config.overrides_count++] = {source, gsi, flags};
+}
+
+
+namespace acpi {
+
+
+struct [[gnu::packed]] rsdp_t {
+	char signature[8];
+	uint8_t checksum;
+	char oem_id[6];
+	uint8_t revision;
+	uint32_t rsdt_address;
+};
+
+
+struct [[gnu::packed]] sdt_header_t {
+	char signature[4];
+	uint32_t length;
+	uint8_t revision;
+	uint8_t checksum;
+	char oem_id[6];
+	char oem_table_id[8];
+	uint32_t oem_revision;
+	uint32_t creator_id;
+	uint32_t creator_revision;
+};
+
+
+struct [[gnu::packed]] madt_t {
+	sdt_header_t header;
+	uint32_t lapic_address;
+	uint32_t flags;
+};
+
+
+enum madt_entry_type_t: uint8_t {
+	local_apic		= 0,
+	io_apic			= 1,
+	source_override		= 2,
+};
+
+
+struct [[gnu::packed]] madt_entry_t {
+	uint8_t type;
+	uint8_t length;
+};
+
+
+struct [[gnu::packed]] madt_local_apic_t {
+	madt_entry_t entry;
+	uint8_t acpi_id;
+	uint8_t apic_id;
+	uint32_t flags;
+};
+
+
+struct [[gnu::packed]] madt_io_apic_t {
+	madt_entry_t entry;
+	uint8_t id;
+	uint8_t reserved;
+	uint32_t address;
+	uint32_t gsi_base;
+};
+
+
+struct [[gnu::packed]] madt_source_override_t {
+	madt_entry_t entry;
+	uint8_t bus;
+	uint8_t source;
+	uint32_t gsi;
+	uint16_t flags;
+};
+
+
+/// Local APIC is enabled.
+constexpr uint32_t LOCAL_APIC_ENABLED = 1 << 0;
+
+
+const madt_t* find_madt()
+{
+	auto rsdp_address = find_in_bios_areas("RSD PTR ", 8, sizeof(rsdp_t));
+	if (!rsdp_address) {
+		return nullptr;
+	}
+
+	auto rsdt = physical<sdt_header_t>(
+		physical<rsdp_t>(rsdp_address)->rsdt_address);
+	if (memcmp(rsdt->signature, "RSDT", 4) != 0
+			|| !checksum_ok(rsdt, rsdt->length)) {
+		LOG_WARN << "invalid RSDT" << lib::endl;
+		return nullptr;
+	}
+
+	const size_t tables = (rsdt->length - sizeof(*rsdt)) / sizeof(uint32_t);
+	auto entries = reinterpret_cast<const uint32_t*>(rsdt + 1);
+	for (size_t i = 0; i != tables; ++i) {
+		auto table = physical<sdt_header_t>(entries[i]);
+		if (memcmp(table->signature, "APIC", 4) == 0
+				&& checksum_ok(table, table->length)) {
+			return reinterpret_cast<const madt_t*>(table);
+		}
+	}
+	return nullptr;
+}
+
+
+bool parse()
+{
+	auto madt = find_madt();
+	if (!madt) {
+		return false;
+	}
+
+	config.lapic_address = madt->lapic_address;
+
+	auto begin = reinterpret_cast<const uint8_t*>(madt + 1);
+	auto end = reinterpret_cast<const uint8_t*>(madt) + madt->header.length;
+	for (auto ptr = begin; ptr < end;) {
+		auto entry = reinterpret_cast<const madt_entry_t*>(ptr);
+		if (entry->length < sizeof(madt_entry_t)) {
+			LOG_WARN << "broken MADT entry" << lib::endl;
+			break;
+		}
+
+		switch (entry->type) {
+		case local_apic: {
+			auto lapic = reinterpret_cast<const madt_local_apic_t*>(entry);
+			if (lapic->flags & LOCAL_APIC_ENABLED) {
+				add_cpu(lapic->apic_id);
+			}
+			break;
+		}
+		case io_apic: {
+			auto ioapic = reinterpret_cast<const madt_io_apic_t*>(entry);
+			add_ioapic(ioapic->id, ioapic->address, ioapic->gsi_base);
+			break;
+		}
+		case source_override: {
+			auto override = reinterpret_cast<const madt_source_override_t*>(entry);
+			add_override(override->source, override->gsi, override->flags);
+			break;
+		}
+		default:
+			break;
+		}
+		ptr += entry->length;
+	}
+
+	config.source = "ACPI";
+	return true;
+}
+
+
+} // namespace acpi
+
+
+namespace mps {
+
+
+struct [[gnu::packed]] floating_pointer_t {
+	char signature[4];
+	uint32_t config_address;
+	uint8_t length;
+	uint8_t spec_revision;
+	uint8_t checksum;
+	uint8_t features[5];
+};
+
+
+struct [[gnu::packed]] config_header_t {
+	char signature[4];
+	uint16_t length;
+	uint8_t spec_revision;
+	uint8_t checksum;
+	char oem_id[8];
+	char product_id[12];
+	uint32_t oem_table;
+	uint16_t oem_table_size;
+	uint16_t entries;
+	uint32_t lapic_address;
+	uint16_t extended_length;
+	uint8_t extended_checksum;
+	uint8_t reserved;
+};
+
+
+enum entry_type_t: uint8_t {
+	processor		= 0,
+	bus			= 1,
+	io_apic			= 2,
+	io_interrupt		= 3,
+	local_interrupt		= 4,
+};
+
+
+struct [[gnu::packed]] processor_entry_t {
+	uint8_t type;
+	uint8_t apic_id;
+	uint8_t apic_version;
+	uint8_t flags;
+	uint32_t signature;
+	uint32_t features;
+	uint32_t reserved[2];
+};
+
+
+struct [[gnu::packed]] bus_entry_t {
+	uint8_t type;
+	uint8_t id;
+	char bus_type[6];
+};
+
+
+struct [[gnu::packed]] io_apic_entry_t {
+	uint8_t type;
+	uint8_t id;
+	uint8_t version;
+	uint8_t flags;
+	uint32_t address;
+};
+
+
+struct [[gnu::packed]] io_interrupt_entry_t {
+	uint8_t type;
+	uint8_t interrupt_type;
+	uint16_t flags;
+	uint8_t source_bus;
+	uint8_t source_irq;
+	uint8_t ioapic_id;
+	uint8_t ioapic_input;
+};
+
+
+/// CPU is usable.
+constexpr uint8_t PROCESSOR_ENABLED = 1 << 0;
+
+/// I/O APIC is usable.
+constexpr uint8_t IO_APIC_ENABLED = 1 << 0;
+
+/// Vectored interrupt, i.e. not NMI, SMI or ExtINT.
+constexpr uint8_t INTERRUPT_INT = 0;
+
+
+/// Maximal number of buses that are tracked to find ISA one.
+constexpr size_t MAX_BUSES = 32;
+
+
+size_t entry_size(uint8_t type)
+{
+	return type == processor ? sizeof(processor_entry_t) : 8;
+}
+
+
+bool parse()
+{
+	auto pointer_address = find_in_bios_areas("_MP_", 4,
+		sizeof(floating_pointer_t));
+	if (!pointer_address) {
+		return false;
+	}
+
+	auto pointer = physical<floating_pointer_t>(pointer_address);
+	if (pointer->features[0] != 0 || !pointer->config_address) {
+		LOG_WARN << "default MP configurations aren't supported"
+			<< lib::endl;
+		return false;
+	}
+
+	auto header = physical<config_header_t>(pointer->config_address);
+	if (memcmp(header->signature, "PCMP", 4) != 0
+			|| !checksum_ok(header, header->length)) {
+		LOG_WARN << "invalid MP configuration table" << lib::endl;
+		return false;
+	}
+
+	config.lapic_address = header->lapic_address;
+
+	bool isa_buses[MAX_BUSES]{};
+	auto ptr = reinterpret_cast<const uint8_t*>(header + 1);
+	for (size_t i = 0; i != header->entries; ++i) {
+		switch (*ptr) {
+		case processor: {
+			auto cpu = reinterpret_cast<const processor_entry_t*>(ptr);
+			if (cpu->flags & PROCESSOR_ENABLED) {
+				add_cpu(cpu->apic_id);
+			}
+			break;
+		}
+		case bus: {
+			auto bus_entry = reinterpret_cast<const bus_entry_t*>(ptr);
+			if (bus_entry->id < MAX_BUSES) {
+				isa_buses[bus_entry->id] =
+					memcmp(bus_entry->bus_type, "ISA", 3) == 0;
+			}
+			break;
+		}
+		case io_apic: {
+			// MP table doesn't tell number of inputs, so global
+			// interrupts are numbered as if each I/O APIC had
+			// 24 of them.
+			auto ioapic = reinterpret_cast<const io_apic_entry_t*>(ptr);
+			if (ioapic->flags & IO_APIC_ENABLED) {
+				add_ioapic(ioapic->id, ioapic->address,
+					config.ioapics_count * DEFAULT_IOAPIC_INPUTS);
+			}
+			break;
+		}
+		case io_interrupt: {
+			auto interrupt = reinterpret_cast<const io_interrupt_entry_t*>(ptr);
+			if (interrupt->interrupt_type != INTERRUPT_INT
+					|| interrupt->source_bus >= MAX_BUSES
+					|| !isa_buses[interrupt->source_bus]) {
+				break;
+			}
+			for (size_t idx = 0; idx != config.ioapics_count; ++idx) {
+				const auto& ioapic = config.ioapics[idx];
+				if (ioapic.id != interrupt->ioapic_id) {
+					continue;
+				}
+				const uint32_t gsi = ioapic.gsi_base + interrupt->ioapic_input;
+				if (gsi != interrupt->source_irq || interrupt->flags) {
+					add_override(interrupt->source_irq, gsi,
+						interrupt->flags);
+				}
+			}
+			break;
+		}
+		default:
+			break;
+		}
+		ptr += entry_size(*ptr);
+	}
+
+	config.source = "MP";
+	return true;
+}
+
+
+} // namespace mps
+
+
+} // namespace
+
+
+const config_t& x86::mp::discover()
+{
+	if (discovered) {
+		return config;
+	}
+	discovered = true;
+
+	if (!acpi::parse() && !mps::parse()) {
+		LOG_NOTICE << "no multiprocessor configuration found" << lib::endl;
+		return config;
+	}
+
+	LOG_NOTICE << "configuration from " << config.source << ": "
+		<< config.cpus_count << " CPUs, "
+		<< config.ioapics_count << " I/O APICs" << lib::endl;
+	return config;
+}
@@ -0,0 +1,171 @@
+#include <x86/smp.hpp>
+
+#include <atomic.hpp>
+#include <cstring.hpp>
+#include <new.hpp>
+
+#include <bolgenos-ng/error.h>
+#include <bolgenos-ng/irq.hpp>
+#include <bolgenos-ng/lapic.hpp>
+#include <bolgenos-ng/memory.hpp>
+#include <bolgenos-ng/time.hpp>
+#include <sched.hpp>
+#include <threading/lock.hpp>
+#include <x86/cpu.hpp>
+#include <x86/mp_config.hpp>
+
+#include <logger.hpp>
+
+#include "config.h"
+
+LOCAL_LOGGER("smp", lib::LogLevel::INFO);
+
+
+/// Start-up code of application processors; see ap_trampoline.sx.
+extern "C" lib::byte ap_trampoline_start[];
+extern "C" lib::byte ap_trampoline_end[];
+extern "C" lib::byte ap_trampoline_stack[];
+extern "C" lib::byte ap_trampoline_entry[];
+extern "C" lib::byte ap_trampoline_arg[];
+
+
+namespace {
+
+
+/// Address the start-up code is copied to. Must match ap_trampoline.sx.
+constexpr uint32_t AP_TRAMPOLINE_BASE = 0x7000;
+
+
+/// Time to wait for a started CPU.
+constexpr uint32_t AP_START_TIMEOUT_MS = 100;
+
+
+/// Application processor has finished its initialization.
+lib::atomic<bool> ap_started{false};
+
+
+/// \brief Handler of reschedule IPI.
+///
+/// The interrupt itself wakes up halted CPU; the flag covers the case when
+/// it comes before CPU halts, see \ref tick::idle.
+class RescheduleHandler: public irq::IRQHandler {
+public:
+	status_t handle_irq(irq::irq_t vector __attribute__((unused))) override
+	{
+		x86::this_cpu()->need_resched.store(true);
+		return status_t::HANDLED;
+	}
+};
+
+
+/// Get field of the copy of start-up code.
+uint32_t& trampoline_field(lib::byte* label)
+{
+	const auto offset = label - ap_trampoline_start;
+	return *reinterpret_cast<uint32_t*>(AP_TRAMPOLINE_BASE + offset);
+}
+
+
+size_t pages_for(size_t size)
+{
+	return (size + PAGE_SIZE - 1) / PAGE_SIZE;
+}
+
+
+/// Entry of application processors in C++ code.
+extern "C" [[noreturn, gnu::cdecl]]
+void ap_main(x86::Processor* processor)
+{
+	processor->load_kernel_segments(lapic::apic_id());
+	processor->load_interrupts_table();
+	lapic::enable();
+
+	LOG_NOTICE << "CPU #" << processor->percpu().index << " is online" << lib::endl;
+	ap_started.store(true);
+
+	irq::enable();
+	sched::details::start_cpu_scheduling();
+}
+
+
+/// \brief Start application processor.
+///
+/// \return true if CPU has started.
+bool start_cpu(uint32_t apic_id)
+{
+	auto processor_memory = memory::alloc_pages(pages_for(sizeof(x86::Processor)));
+	auto stack = static_cast<lib::byte*>(
+		memory::alloc_pages(pages_for(KERNEL_STACK_SIZE)));
+	if (!processor_memory || !stack) {
+		panic("failed to allocate memory for application processor");
+	}
+	auto processor = new(processor_memory) x86::Processor{};
+
+	trampoline_field(ap_trampoline_stack) = reinterpret_cast<uint32_t>(
+		stack + pages_for(KERNEL_STACK_SIZE) * PAGE_SIZE);
+	trampoline_field(ap_trampoline_entry) = reinterpret_cast<uint32_t>(ap_main);
+	trampoline_field(ap_trampoline_arg) = reinterpret_cast<uint32_t>(processor);
+	ap_started.store(false);
+
+	LOG_INFO << "starting CPU with local APIC #" << apic_id << lib::endl;
+	lapic::send_ipi(apic_id, lapic::icr_init | lapic::icr_assert | lapic::icr_level);
+	sleep_ms(10);
+	for (int i = 0; i < 2; ++i) {
+		lapic::send_ipi(apic_id, lapic::icr_startup | (AP_TRAMPOLINE_BASE >> 12));
+		time::sleep_us(200);
+	}
+
+	const uint64_t timeout = time::now_ms() + AP_START_TIMEOUT_MS;
+	while (!ap_started.load()) {
+		if (time::now_ms() > timeout) {
+			// CPU may still start later and use the memory, so it
+			// isn't released.
+			LOG_ERROR << "CPU with local APIC #" << apic_id
+				<< " hasn't started" << lib::endl;
+			return false;
+		}
+		sleep_ms(1);
+	}
+	return true;
+}
+
+
+} // namespace
+
+
+void x86::smp::init()
+{
+	if (!SMP) {
+		return;
+	}
+
+	if (!lapic::is_enabled()) {
+		LOG_NOTICE << "local APIC isn't used, other CPUs aren't started"
+			<< lib::endl;
+		return;
+	}
+
+	const auto boot_apic_id = lapic::apic_id();
+	this_cpu()->apic_id = boot_apic_id;
+
+	const auto& config = mp::discover();
+	if (config.cpus_count < 2) {
+		LOG_NOTICE << "no other CPUs found" << lib::endl;
+		return;
+	}
+
+	irq::InterruptsManager::instance()->add_handler(lapic::reschedule_vector,
+		new RescheduleHandler());
+	thr::details::enable_kernel_lock();
+
+	memcpy(reinterpret_cast<void*>(AP_TRAMPOLINE_BASE), ap_trampoline_start,
+		ap_trampoline_end - ap_trampoline_start);
+
+	for (size_t i = 0; i < config.cpus_count; ++i) {
+		if (config.cpus[i] != boot_apic_id) {
+			start_cpu(config.cpus[i]);
+		}
+	}
+
+	LOG_NOTICE << online_cpus() << " CPUs are online" << lib::endl;
+}
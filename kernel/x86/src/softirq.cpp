@@ -0,0 +1,90 @@
+#include <bolgenos-ng/softirq.hpp>
+
+#include <atomic.hpp>
+
+#include <bolgenos-ng/irq.hpp>
+#include <threading/threading.hpp>
+
+
+namespace {
+
+
+/// Head of queue of scheduled tasklets.
+irq::Tasklet* pending_head = nullptr;
+
+/// Tail of queue of scheduled tasklets.
+irq::Tasklet** pending_tail = &pending_head;
+
+/// Lock that protects the queue.
+thr::IrqSpinLock pending_lock{"tasklets"};
+
+/// Tasklets are being run by some CPU.
+lib::atomic<bool> running{false};
+
+
+} // namespace
+
+
+void irq::Tasklet::schedule()
+{
+	thr::with_lock(pending_lock, [this]() {
+		if (_scheduled) {
+			return;
+		}
+		_scheduled = true;
+		_next = nullptr;
+		*pending_tail = this;
+		pending_tail = &_next;
+	});
+
+	if (!irq::in_interrupt() && irq::is_enabled()) {
+		run_tasklets();
+	}
+}
+
+
+void irq::run_tasklets()
+{
+	const bool was_enabled = irq::disable(false);
+	if (running.exchange(true)) {
+		if (was_enabled) {
+			irq::enable(false);
+		}
+		return;
+	}
+
+	while (true) {
+		Tasklet* batch = thr::with_lock(pending_lock, []() {
+			Tasklet* head = pending_head;
+			pending_head = nullptr;
+			pending_tail = &pending_head;
+			if (!head) {
+				// Cleared under the lock, so a tasklet scheduled
+				// by another CPU is either taken here or run by
+				// that CPU.
+				running.store(false);
+			}
+			return head;
+		});
+		if (!batch) {
+			break;
+		}
+
+		irq::enable(false);
+		while (batch) {
+			Tasklet* tasklet = batch;
+			batch = tasklet->_next;
+
+			thr::with_lock(pending_lock, [tasklet]() {
+				tasklet->_scheduled = false;
+			});
+
+			tasklet->_routine(tasklet->_arg);
+		}
+		irq::disable(false);
+	}
+
+	if (was_enabled) {
+		irq::enable(false);
+	}
+}
@@ -1,8 +1,8 @@
 #include <x86/tss.hpp>
 
+#include <format.hpp>
 #include <ostream.hpp>
 #include <type_traits.hpp>
-#include <ext/scoped_format_guard.hpp>
 #include <x86/gdt.hpp>
 
 using namespace lib;
@@ -16,27 +16,19 @@ static_assert(is_standard_layout_v<x86::TaskStateSegment>);
 
 lib::ostream& x86::tss::operator<<(ostream& out, const x86::tss::SegmentRegister& segment_register)
 {
-	ScopedFormatGuard format_guard{out};
-	return out << dec << segment_register.segment();
+	return format_to(out, "{}", segment_register.segment());
 }
 
 ostream& x86::tss::operator<<(ostream& out, const x86::tss::ProtectionRingStack& stack)
 {
-	ScopedFormatGuard guard{out};
-	return out << dec << stack.segment() << ":" << hex << static_cast<const void*>(stack.pointer());
+	return format_to(out, "{}:{:x}", stack.segment(), stack.pointer());
 }
 
 lib::ostream& x86::operator<<(lib::ostream& out, const TaskStateSegment& tss)
 {
-	lib::ScopedFormatGuard guard{out};
-	return out << hex
-		<< "tss{"
-		<< "prev=" << tss.previous_task_link
-		<< ",stack_0=" << tss.stack[0]
-		<< ",isp=" << reinterpret_cast<uint32_t>(tss.instruction_ptr)
-		<< ",eflags=" << tss.eflags
-		<< ",cs=" << tss._segment_registers.cs
-		<< "}";
+	return format_to(out, "tss{{prev={:x},stack_0={},isp={:x},eflags={:x},cs={}}}",
+		tss.previous_task_link, tss.stack[0], tss.instruction_ptr,
+		tss.eflags, tss._segment_registers.cs);
 }
 
 x86::tss::SegmentRegistersPack x86::tss::SegmentRegistersPack::kernel()
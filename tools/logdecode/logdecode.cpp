@@ -0,0 +1,245 @@
+// Decoder of kernel binary log.
+//
+// The tool reads serial output of the kernel, passes text log through and
+// replaces frames of binary log (see log/include/log/binary.hpp) with
+// formatted lines. Formats are taken from `.log_formats` section of
+// kernel.bin that produced the output.
+//
+// Usage: logdecode <kernel.bin> [captured output]
+//
+// Output is read from stdin if file isn't specified, e.g.
+//	qemu-system-i386 -kernel kernel.bin -serial stdio | logdecode kernel.bin
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+
+constexpr uint8_t FRAME_MAGIC[] = {0xff, 0xb1};
+
+constexpr const char* LEVELS[] = {
+	"CRIT", "ERROR", "WARN", "NOTICE", "INFO", "DEBUG"
+};
+
+
+struct Format {
+	unsigned level;
+	unsigned words;
+	std::string text;
+};
+
+
+template<class T>
+T read_le(const uint8_t* data)
+{
+	T value = 0;
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		value |= static_cast<T>(data[i]) << (8 * i);
+	}
+	return value;
+}
+
+
+/// Read formats from `.log_formats` section of ELF32 file.
+bool load_formats(const char* path, std::map<uint32_t, Format>& formats)
+{
+	std::ifstream file{path, std::ios::binary};
+	const std::vector<uint8_t> elf{std::istreambuf_iterator<char>{file}, {}};
+	if (elf.size() < 0x34 || std::memcmp(elf.data(), "\x7f" "ELF\x01", 5)) {
+		std::cerr << path << ": not an ELF32 file\n";
+		return false;
+	}
+
+	const uint32_t shoff = read_le<uint32_t>(&elf[0x20]);
+	const uint16_t shentsize = read_le<uint16_t>(&elf[0x2e]);
+	const uint16_t shnum = read_le<uint16_t>(&elf[0x30]);
+	const uint16_t shstrndx = read_le<uint16_t>(&elf[0x32]);
+	if (shoff + static_cast<size_t>(shnum) * shentsize > elf.size()) {
+		std::cerr << path << ": broken section table\n";
+		return false;
+	}
+	auto section = [&](unsigned index) { return &elf[shoff + index * shentsize]; };
+	const uint32_t names = read_le<uint32_t>(section(shstrndx) + 16);
+
+	for (unsigned i = 0; i < shnum; ++i) {
+		const uint8_t* header = section(i);
+		const char* name = reinterpret_cast<const char*>(
+			&elf[names + read_le<uint32_t>(header)]);
+		if (std::strcmp(name, ".log_formats")) {
+			continue;
+		}
+
+		const uint32_t address = read_le<uint32_t>(header + 12);
+		const uint32_t offset = read_le<uint32_t>(header + 16);
+		const uint32_t size = read_le<uint32_t>(header + 20);
+		if (offset + static_cast<size_t>(size) > elf.size()) {
+			std::cerr << path << ": broken .log_formats section\n";
+			return false;
+		}
+		uint32_t position = 0;
+		while (position + 4 <= size) {
+			const uint8_t* entry = &elf[offset + position];
+			// Compiler may align entries by more than 4 bytes; padding
+			// is zero, while text of every format is non-empty.
+			if (read_le<uint32_t>(entry) == 0) {
+				position += 4;
+				continue;
+			}
+			const uint16_t length = read_le<uint16_t>(entry + 2);
+			if (position + 4 + length > size) {
+				break;
+			}
+			formats[address + position] = Format{
+				entry[0], entry[1],
+				std::string{reinterpret_cast<const char*>(entry + 4), length}
+			};
+			// Entries are aligned by 4 bytes.
+			position += (4 + length + 1 + 3) & ~3u;
+		}
+		return true;
+	}
+
+	// Kernel that has no binary log statements still emits the section,
+	// but images built before it did may lack it: text is passed through.
+	std::cerr << path << ": no .log_formats section\n";
+	return true;
+}
+
+
+std::string format_args(const std::string& text, const uint32_t* args,
+	unsigned words)
+{
+	std::string result;
+	unsigned next = 0;
+	char buffer[32];
+	for (size_t i = 0; i < text.size(); ++i) {
+		if (text[i] != '%' || i + 1 == text.size()) {
+			result += text[i];
+			continue;
+		}
+		++i;
+		if (text[i] == '%') {
+			result += '%';
+			continue;
+		}
+
+		unsigned longs = 0;
+		for (; i < text.size() && text[i] == 'l'; ++i) {
+			++longs;
+		}
+		uint64_t value = 0;
+		const unsigned needed = longs >= 2 ? 2 : 1;
+		if (next + needed > words) {
+			result += "<missing>";
+			continue;
+		}
+		value = args[next++];
+		if (needed == 2) {
+			value |= static_cast<uint64_t>(args[next++]) << 32;
+		}
+
+		switch (i < text.size() ? text[i] : 'u') {
+		case 'd':
+			if (needed == 2) {
+				std::snprintf(buffer, sizeof(buffer), "%" PRId64,
+					static_cast<int64_t>(value));
+			} else {
+				std::snprintf(buffer, sizeof(buffer), "%" PRId32,
+					static_cast<int32_t>(value));
+			}
+			break;
+		case 'x':
+			std::snprintf(buffer, sizeof(buffer), "%" PRIx64, value);
+			break;
+		case 'p':
+			std::snprintf(buffer, sizeof(buffer), "0x%08" PRIx64, value);
+			break;
+		case 'c':
+			std::snprintf(buffer, sizeof(buffer), "%c",
+				static_cast<char>(value));
+			break;
+		default:
+			std::snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+			break;
+		}
+		result += buffer;
+	}
+	return result;
+}
+
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3) {
+		std::cerr << "usage: " << argv[0]
+			<< " <kernel.bin> [captured output]\n";
+		return 2;
+	}
+
+	std::map<uint32_t, Format> formats;
+	if (!load_formats(argv[1], formats)) {
+		return 1;
+	}
+
+	std::ifstream file;
+	if (argc == 3) {
+		file.open(argv[2], std::ios::binary);
+		if (!file) {
+			std::cerr << argv[2] << ": can't open\n";
+			return 1;
+		}
+	}
+	std::istream& in = argc == 3 ? file : std::cin;
+	const std::vector<uint8_t> data{std::istreambuf_iterator<char>{in}, {}};
+
+	// magic, cpu, words, format, tsc
+	constexpr size_t HEADER_SIZE = 2 + 1 + 1 + 4 + 8;
+	size_t i = 0;
+	while (i < data.size()) {
+		if (data[i] != FRAME_MAGIC[0] || i + HEADER_SIZE > data.size()
+				|| data[i + 1] != FRAME_MAGIC[1]) {
+			if (data[i] != '\r') {
+				std::cout.put(static_cast<char>(data[i]));
+			}
+			++i;
+			continue;
+		}
+
+		const unsigned cpu = data[i + 2];
+		const unsigned words = data[i + 3];
+		const uint32_t id = read_le<uint32_t>(&data[i + 4]);
+		const uint64_t tsc = read_le<uint64_t>(&data[i + 8]);
+		if (i + HEADER_SIZE + words * 4 > data.size()) {
+			break;
+		}
+		std::vector<uint32_t> args(words);
+		for (unsigned word = 0; word < words; ++word) {
+			args[word] = read_le<uint32_t>(&data[i + HEADER_SIZE + word * 4]);
+		}
+		i += HEADER_SIZE + words * 4;
+
+		const auto format = formats.find(id);
+		std::cout << "[cpu " << cpu << " tsc " << tsc << "] ";
+		if (format == formats.end()) {
+			std::cout << "unknown format 0x" << std::hex << id << std::dec
+				<< '\n';
+			continue;
+		}
+		const unsigned level = format->second.level;
+		std::cout << (level < std::size(LEVELS) ? LEVELS[level] : "?") << ' '
+			<< format_args(format->second.text, args.data(), words) << '\n';
+	}
+	return 0;
+}